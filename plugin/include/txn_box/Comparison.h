@@ -18,6 +18,11 @@
 #include "txn_box/Accelerator.h"
 #include "txn_box/yaml_util.h"
 
+namespace ts
+{
+class ShardedStat;
+}
+
 /** Base class for comparisons.
  *
  */
@@ -193,9 +198,22 @@ class ComparisonGroupBase
   using Errata    = swoc::Errata;
 
 public:
+  /// Key in a case for a stat counting matches of the case.
+  static constexpr swoc::TextView STAT_KEY = "stat";
+
   virtual ~ComparisonGroupBase() = default;
   virtual Errata load(Config &cfg, YAML::Node node);
 
+  /** Load the match counter for a case.
+   *
+   * @param cfg Configuration context.
+   * @param node Case node.
+   * @return The counter, @c nullptr if there is no @c STAT_KEY in @a node, or errors.
+   *
+   * The value must be a literal string, which is the stat name without the plugin prefix.
+   */
+  static swoc::Rv<std::unique_ptr<ts::ShardedStat>> load_stat(Config &cfg, YAML::Node node);
+
 protected:
   virtual Errata load_case(Config &cfg, YAML::Node node) = 0;
   swoc::Rv<Comparison::Handle> load_cmp(Config &cfg, YAML::Node node);
@@ -296,13 +314,15 @@ auto
 ComparisonGroup<W>::load_case(Config &cfg, YAML::Node node) -> Errata
 {
   W w;
-  if (auto errata = w.pre_load(cfg, node); !errata.is_ok()) {
-    return errata;
+  auto &&[case_key_count, case_errata] = w.pre_load(cfg, node);
+  if (!case_errata.is_ok()) {
+    return std::move(case_errata);
   }
 
   // It is permitted to have an empty comparison, which always matches and is marked by a
-  // nil handle.
-  if (node.size() >= 1) {
+  // nil handle. Keys handled by @a pre_load are left in @a node so the YAML isn't modified and
+  // can be loaded again, therefore only a key beyond those indicates a comparison.
+  if (node.size() > case_key_count) {
     auto &&[handle, errata] = this->load_cmp(cfg, node);
     if (!errata.is_ok()) {
       return std::move(errata);
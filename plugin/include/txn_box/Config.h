@@ -9,6 +9,11 @@
 
 #include <array>
 #include <vector>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
@@ -18,12 +23,60 @@
 #include <swoc/swoc_file.h>
 
 #include "txn_box/common.h"
+#include "txn_box/Accelerator.h"
 #include "txn_box/Extractor.h"
 #include "txn_box/Expr.h"
 #include "txn_box/FeatureGroup.h"
 #include "txn_box/Directive.h"
 #include "txn_box/yaml_util.h"
 
+/** Process wide store of immutable strings.
+ *
+ * Strings localized in configurations are often the same across configurations - header names,
+ * host names, other literals. Each distinct string is stored once here and shared among all of the
+ * configurations that use it. A configuration holds a reference to each string it uses, which is
+ * released when the configuration is destroyed.
+ */
+class StringInterner
+{
+  using self_type = StringInterner; ///< Self reference type.
+public:
+  /** Get the shared copy of @a text.
+   *
+   * @param text Text to store.
+   * @return A view of the shared copy, which is also null terminated.
+   *
+   * A reference is added for the string, which must be released with @c release.
+   */
+  swoc::TextView add(swoc::TextView text);
+
+  /** Release a reference to a string.
+   *
+   * @param text View returned from @c add.
+   */
+  void release(swoc::TextView text);
+
+  /// @return The number of distinct strings.
+  size_t count() const;
+
+  /// @return The total size of the distinct strings.
+  size_t size() const;
+
+  /// @return The process wide instance.
+  static self_type &instance();
+
+protected:
+  /// Storage for a string.
+  struct Item {
+    std::unique_ptr<char[]> _text; ///< String content.
+    unsigned _refs = 0;            ///< Reference count.
+  };
+
+  mutable std::mutex _mutex;                    ///< Lock for access to @a _map.
+  std::unordered_map<std::string_view, Item> _map; ///< Keyed by view of @a Item::_text.
+  size_t _size = 0;                             ///< Total size of the strings.
+};
+
 /// Contains a configuration and configuration helper methods.
 /// This is also used to pass information between node parsing during configuration loading.
 class Config
@@ -146,9 +199,61 @@ public:
   /// External handle to instances.
   using Handle = std::shared_ptr<self_type>;
 
-  /// Cache of parsed YAML for files.
-  /// @note Used only for remap.
-  using YamlCache = std::unordered_map<swoc::file::path, YAML::Node>;
+  /** Cache of parsed YAML for files.
+   *
+   * Each entry is stamped with the modification time, size, and content hash of the file. An
+   * entry is reused if the file is unchanged, which avoids parsing the YAML for files that are
+   * loaded by many remap rules or that did not change between reloads.
+   *
+   * Loading must not modify the YAML nodes in a way that changes the result of a later load, as
+   * the nodes are shared among loads.
+   *
+   * Each file is checked against the file system once per generation. A file already checked in the
+   * current generation is reused without further checks. A generation should correspond to a
+   * single configuration load, which may load the same file many times.
+   */
+  class YamlCache
+  {
+    using self_type = YamlCache; ///< Self reference type.
+  public:
+    /** Get the YAML for a file.
+     *
+     * @param path Absolute path to the file.
+     * @return The root node of the YAML in @a path, or errors.
+     */
+    swoc::Rv<YAML::Node> load(swoc::file::path const &path);
+
+    /// Start a new generation, requiring all entries to be checked again.
+    void advance();
+
+    /// Discard entries not used in the current generation.
+    void sweep();
+
+    /// Discard all entries.
+    void clear();
+
+    /// Number of loads in this generation that reused a parsed tree.
+    unsigned reuse_count() const { return _reuse_count; }
+    /// Number of loads in this generation that parsed a file.
+    unsigned parse_count() const { return _parse_count; }
+    /// The current generation.
+    unsigned generation() const { return _generation; }
+
+  protected:
+    /// Cache entry.
+    struct Item {
+      YAML::Node _root;                                ///< Parsed YAML.
+      std::chrono::system_clock::time_point _mtime{}; ///< Modification time of the file when checked.
+      uintmax_t _size = 0;                             ///< Size of the file when checked.
+      size_t _hash    = 0;                             ///< Hash of the file content.
+      unsigned _generation = 0;                        ///< Generation in which it was last checked.
+    };
+
+    std::unordered_map<swoc::file::path, Item> _map; ///< Cached files.
+    unsigned _generation  = 1; ///< Current generation.
+    unsigned _reuse_count = 0; ///< # of loads that reused a parsed tree.
+    unsigned _parse_count = 0; ///< # of loads that parsed YAML.
+  };
 
   /// Default constructor, makes an empty instance.
   Config();
@@ -269,7 +374,8 @@ public:
    * @return The localized copy.
    *
    * Strings in the YAML configuration are transient. If the content needs to be available at
-   * run time it must be first localized.
+   * run time it must be first localized. The localized copy is shared with other configurations
+   * via @c StringInterner and therefore must not be modified. It is always null terminated.
    */
   swoc::TextView &localize(swoc::TextView &text, LocalOpt opt = LOCAL_VIEW);
   swoc::TextView
@@ -459,6 +565,33 @@ public:
     return _cfg_file_count;
   }
 
+  /// @return The path of the file being loaded, empty if not loading from a file.
+  swoc::TextView
+  current_file() const
+  {
+    return _cur_file;
+  }
+
+  /// @return The profiling sample rate, 1 in this many directive invocations, or 0 if disabled.
+  unsigned
+  profile_sample() const
+  {
+    return _profile_sample;
+  }
+
+  /** Hook time sample rate.
+   *
+   * @return The sample rate set by the @c hook-time argument, if any.
+   *
+   * This is only parsed by @c load_cli_args, as it is process wide it must be applied with
+   * @c Context::enable_hook_time by the global plugin after the configuration is loaded.
+   */
+  std::optional<unsigned>
+  hook_time_sample() const
+  {
+    return _hook_time_sample;
+  }
+
   /// @return The total amount of context storage reserved.
   size_t
   reserved_ctx_storage_size() const
@@ -466,6 +599,52 @@ public:
     return _ctx_storage_required;
   }
 
+  /// @return The amount of memory allocated by the configuration arena.
+  size_t
+  arena_size() const
+  {
+    return _arena.allocated_size();
+  }
+
+  /// @return The number of distinct strings localized in this configuration.
+  size_t
+  string_count() const
+  {
+    return _interned.size();
+  }
+
+  /// @return The total size of distinct strings localized in this configuration.
+  size_t
+  string_size() const
+  {
+    return _interned_size;
+  }
+
+  /// @return The number of directives loaded in to this configuration.
+  size_t directive_count() const;
+
+  /** Track a loaded comparison.
+   *
+   * @param cmp The comparison.
+   *
+   * This records whether @a cmp can be accelerated, for diagnostics.
+   */
+  void note_comparison(Comparison const &cmp);
+
+  /// @return The number of comparisons loaded in to this configuration.
+  unsigned
+  comparison_count() const
+  {
+    return _cmp_count;
+  }
+
+  /// @return The number of comparisons that are candidates for each accelerator.
+  Accelerator::Counters const &
+  accelerator_counters() const
+  {
+    return _accl_counters;
+  }
+
   template <typename T>
   T *
   active_value(swoc::TextView const &name)
@@ -491,6 +670,7 @@ protected:
   /// As the top level directive, this needs special access.
   friend class When;
   friend class Context;
+  friend class Do_ua_req_body_inspect; // loads directives for a different hook.
 
   // Transient properties
   /// Current hook for directives being loaded.
@@ -551,9 +731,17 @@ protected:
   /// directive load, if needed. This includes the top level directives.
   std::array<size_t, std::tuple_size<Hook>::value> _directive_count{0};
 
-  /// For localizing data at a configuration level, primarily strings.
+  /// For localizing data at a configuration level.
   swoc::MemArena _arena;
 
+  /// Strings localized by this configuration, stored in the @c StringInterner.
+  std::unordered_set<std::string_view> _interned;
+  /// Total size of @a _interned strings.
+  size_t _interned_size = 0;
+
+  unsigned _cmp_count = 0;                ///< Number of comparisons.
+  Accelerator::Counters _accl_counters{}; ///< Accelerator candidate counts.
+
   /// Additional clean up to perform when @a this is destroyed.
   swoc::IntrusiveDList<Finalizer::Linkage> _finalizers;
 
@@ -643,8 +831,20 @@ protected:
   /// # of configuration files tracked.
   /// Used for diagnostics.
   size_t _cfg_file_count = 0;
+  /// File being loaded, transient.
+  swoc::TextView _cur_file;
+  /// Profile directives, sampling 1 in this many invocations. 0 => disabled.
+  unsigned _profile_sample = 0;
+  /// Hook time sample rate from the arguments, if set. Applied by the caller after a successful load.
+  std::optional<unsigned> _hook_time_sample;
 };
 
+/** Format a summary of the resource use of a configuration.
+ *
+ * This is the arena size, localized string size and count, and the directive counts.
+ */
+swoc::BufferWriter &bwformat(swoc::BufferWriter &w, swoc::bwf::Spec const &spec, Config const &cfg);
+
 inline bool
 Config::FileInfo::has_cfg_key(swoc::TextView key) const
 {
@@ -66,6 +66,23 @@ public:
    */
   swoc::Errata invoke_for_remap(Config &rule_cfg, TSRemapRequestInfo *rri);
 
+  /** Enable per hook time accounting.
+   *
+   * @param sample Account for about 1 in this many transactions, 0 to disable.
+   * @return Errors, if any.
+   *
+   * This is process wide and applies to transactions started after the call. A histogram stat of
+   * the time for each transaction hook is created the first time accounting is enabled.
+   */
+  static swoc::Errata enable_hook_time(unsigned sample);
+
+  /** Time spent invoking directives for a hook.
+   *
+   * @param hook Hook, or @c Hook::INVALID for the total of all hooks.
+   * @return The time for @a hook, or a negative duration if this transaction is not accounted.
+   */
+  std::chrono::nanoseconds hook_time(Hook hook) const;
+
   /** Set up to handle the hooks in the @a txn.
    *
    * @param txn TS transaction object.
@@ -630,6 +647,24 @@ protected:
   /// Flag for continuing invoking directives.
   bool _terminal_p = false;
 
+  /// Account for time spent per hook for this transaction.
+  bool _hook_time_p = false;
+  /// Time spent invoking directives per hook.
+  std::array<std::chrono::nanoseconds, std::tuple_size<Hook>::value> _hook_time{};
+
+  /// Process wide hook time accounting.
+  struct HookTime {
+    std::mutex _mutex;                ///< Serialize enabling.
+    std::atomic<unsigned> _sample{0}; ///< Account 1 in this many transactions, 0 => disabled.
+    /// Time histogram per hook, in nanoseconds.
+    std::array<std::unique_ptr<ts::HistogramStat>, std::tuple_size<Hook>::value> _stats;
+  };
+  /// @return The hook time accounting singleton.
+  static HookTime &hook_time_info();
+
+  /// Add the time since @a start to the time for @a hook.
+  void account_hook_time(Hook hook, std::chrono::steady_clock::time_point start);
+
   /// Invoke the callbacks for the current hook.
   swoc::Errata invoke_callbacks();
 
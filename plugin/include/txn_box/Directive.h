@@ -228,6 +228,56 @@ protected:
   Lambda _f;
 };
 
+/** Wrapper to profile another directive.
+ *
+ * This is put around every directive loaded from configuration if profiling is enabled, and not
+ * used at all otherwise. A sample of invocations is timed with the CPU cycle counter, and the number
+ * of samples and total cycles are added to plugin stats labeled with the file and line of the
+ * directive. The time includes any nested directives.
+ *
+ * Plugin stats can not be removed and their number is limited by Traffic Server, therefore at most
+ * @c MAX_PROFILED directive locations are profiled per process.
+ */
+class ProfileDirective : public Directive
+{
+  using self_type  = ProfileDirective; ///< Self reference type.
+  using super_type = Directive;        ///< Parent type.
+
+public:
+  /// Maximum number of directive locations to profile.
+  static constexpr unsigned MAX_PROFILED = 64;
+
+  /** Wrap a directive.
+   *
+   * @param cfg Configuration being loaded.
+   * @param drtv Directive to profile.
+   * @param name Directive name.
+   * @param mark Location of the directive.
+   * @return The wrapper, or @a drtv if it can not be profiled.
+   *
+   * If the limit has been reached or the stats can not be created, a warning is logged and the
+   * directive is not profiled.
+   */
+  static Handle make(Config &cfg, Handle &&drtv, swoc::TextView const &name, YAML::Mark const &mark);
+
+  /** Invoke the directive.
+   *
+   * @param ctx The transaction context.
+   * @return Errors, if any.
+   *
+   * The wrapped directive is invoked, and timed if sampled.
+   */
+  swoc::Errata invoke(Context &ctx) override;
+
+protected:
+  Handle _drtv;         ///< Wrapped directive.
+  unsigned _sample = 1; ///< Time 1 in this many invocations.
+  std::unique_ptr<ts::ShardedStat> _samples; ///< Sample count.
+  std::unique_ptr<ts::ShardedStat> _cycles;  ///< Total cycles in samples.
+
+  ProfileDirective(Handle &&drtv, unsigned sample) : _drtv(std::move(drtv)), _sample(sample) {}
+};
+
 inline Hook
 When::get_hook() const
 {
@@ -0,0 +1,189 @@
+/** @file
+ *  Epoch based reclamation of shared data.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/** Epoch based reclamation.
+ *
+ * Readers enter the domain to get a @c Guard and then may use pointers to data managed by the
+ * domain with plain loads, until the guard is destroyed. Data replaced by a writer is retired to the
+ * domain and destroyed only when every guard that existed at the time of retirement is gone. A guard
+ * therefore keeps everything retired while it exists, and so should be held only briefly, e.g. while
+ * taking a reference to the current data. Holding one for a long time, such as for a transaction,
+ * keeps every version retired meanwhile.
+ *
+ * Entering and leaving touch only a counter in a slot chosen by thread, therefore readers on
+ * different threads rarely contend. Writers are serialized with a mutex. The domain advances
+ * its epoch lazily, in @c retire and @c reclaim, and so retired data is destroyed only by those
+ * methods or by the destructor.
+ */
+class Epoch
+{
+  using self_type = Epoch; ///< Self reference type.
+
+public:
+  /// Number of counter slots for readers.
+  static constexpr unsigned N_SLOTS = 32;
+
+  /// Reader presence in the domain. Leaves the domain on destruction.
+  class Guard
+  {
+    using self_type = Guard; ///< Self reference type.
+    friend Epoch;
+
+  public:
+    Guard() = default;
+    Guard(self_type &&that) noexcept : _domain(that._domain), _epoch(that._epoch), _slot(that._slot) { that._domain = nullptr; }
+    self_type &
+    operator=(self_type &&that) noexcept
+    {
+      if (this != &that) {
+        this->release();
+        _domain      = that._domain;
+        _epoch       = that._epoch;
+        _slot        = that._slot;
+        that._domain = nullptr;
+      }
+      return *this;
+    }
+    ~Guard() { this->release(); }
+
+    /// Leave the domain, if entered.
+    void
+    release()
+    {
+      if (_domain) {
+        _domain->_slots[_slot]._active[_epoch & 1].fetch_sub(1);
+        _domain = nullptr;
+      }
+    }
+
+  protected:
+    Epoch *_domain = nullptr; ///< Domain entered.
+    uint64_t _epoch = 0;      ///< Epoch when entered.
+    unsigned _slot  = 0;      ///< Counter slot.
+
+    Guard(Epoch *domain, uint64_t epoch, unsigned slot) : _domain(domain), _epoch(epoch), _slot(slot) {}
+  };
+
+  Epoch() = default;
+  Epoch(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Enter the domain.
+   *
+   * @return A guard for the current epoch.
+   *
+   * This never blocks. Data retired after this call is not destroyed while the guard exists. The
+   * guard may be destroyed on a different thread.
+   */
+  Guard
+  enter()
+  {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned slot = next++ % N_SLOTS;
+    while (true) {
+      auto epoch = _epoch.load();
+      auto &n    = _slots[slot]._active[epoch & 1];
+      ++n;
+      if (epoch == _epoch.load()) {
+        return {this, epoch, slot};
+      }
+      --n; // epoch changed and the counter may already have been checked - try again.
+    }
+  }
+
+  /** Retire data.
+   *
+   * @param item Data to retire.
+   *
+   * @a item must already be unreachable for new readers. It is kept until all current guards are
+   * gone. Retired data that is no longer in use is destroyed.
+   */
+  void
+  retire(std::shared_ptr<void const> item)
+  {
+    std::lock_guard lock(_mutex);
+    if (item) {
+      _retired.emplace_back(_epoch.load(), std::move(item));
+    }
+    this->reclaim_locked();
+  }
+
+  /// Destroy retired data that is no longer in use.
+  void
+  reclaim()
+  {
+    std::lock_guard lock(_mutex);
+    this->reclaim_locked();
+  }
+
+  /// @return The number of retired items not yet destroyed.
+  size_t
+  retired_count() const
+  {
+    std::lock_guard lock(_mutex);
+    return _retired.size();
+  }
+
+protected:
+  /// Reader counters, one per epoch parity.
+  struct alignas(64) Slot {
+    std::array<std::atomic<int>, 2> _active{};
+  };
+
+  std::atomic<uint64_t> _epoch{0};     ///< Global epoch.
+  std::array<Slot, N_SLOTS> _slots;    ///< Reader counters.
+  mutable std::mutex _mutex;           ///< Writer lock.
+  /// Retired items with the epoch of retirement, oldest first.
+  std::deque<std::pair<uint64_t, std::shared_ptr<void const>>> _retired;
+
+  /// @return @c true if there are no readers for epochs with parity @a parity.
+  bool
+  is_clear(unsigned parity) const
+  {
+    for (auto const &slot : _slots) {
+      if (slot._active[parity].load() != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Advance the epoch if possible and destroy retired items - @a _mutex must be held.
+   *
+   * Readers are always in the current or previous epoch. The epoch can advance when there are no
+   * readers in the previous epoch, because that parity is reused for the next epoch. An item
+   * retired in epoch @c E can be destroyed once the epoch is @c E+2 as all readers are then in
+   * epochs later than @c E.
+   */
+  void
+  reclaim_locked()
+  {
+    if (_retired.empty()) {
+      return; // no need to advance.
+    }
+    auto epoch = _epoch.load();
+    if (this->is_clear((epoch + 1) & 1)) {
+      _epoch.store(++epoch);
+      if (this->is_clear((epoch + 1) & 1)) { // readers may already be gone.
+        _epoch.store(++epoch);
+      }
+    }
+    while (!_retired.empty() && _retired.front().first + 2 <= epoch) {
+      _retired.pop_front();
+    }
+  }
+};
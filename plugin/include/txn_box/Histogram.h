@@ -0,0 +1,177 @@
+/** @file
+ *  Lock free histogram with log-linear buckets.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/** Histogram of unsigned values with log-linear buckets.
+ *
+ * Each power of two range is split in to 2^precision buckets of equal width, so the relative width
+ * of a bucket is at most 2^-precision. Values smaller than 2^precision have a bucket each. Only the
+ * buckets for the range [min, max] are kept. Smaller values are counted in the first bucket and
+ * larger values in a final overflow bucket.
+ *
+ * Recording touches only the counters in a shard chosen by thread, with relaxed atomic adds, so
+ * threads rarely contend and never block. Each shard starts on a cache line and is padded to a whole
+ * number of cache lines so shards do not share lines. Counts are collected by draining, which moves the counts
+ * from all shards to the caller.
+ */
+class Histogram
+{
+  using self_type = Histogram; ///< Self reference type.
+
+public:
+  /// Number of counter shards.
+  static constexpr unsigned N_SHARDS = 32;
+  /// Limit for the precision.
+  static constexpr unsigned MAX_PRECISION = 8;
+  /// Upper bound of the overflow bucket.
+  static constexpr uint64_t NO_BOUND = std::numeric_limits<uint64_t>::max();
+
+  /** Construct.
+   *
+   * @param min Smallest value of interest.
+   * @param max Largest value of interest.
+   * @param precision Number of bits for buckets in each power of two range.
+   *
+   * @a precision is clipped to @c MAX_PRECISION and @a max to at least @a min.
+   */
+  Histogram(uint64_t min, uint64_t max, unsigned precision)
+    : _precision(std::min(precision, MAX_PRECISION)),
+      _lo(this->log_bucket(min)),
+      _hi(this->log_bucket(std::max(min, max))),
+      _n_buckets(_hi - _lo + 2),
+      _shard_lines((_n_buckets + 1 + Line::N - 1) / Line::N), // buckets and the sum.
+      _lines(new Line[N_SHARDS * _shard_lines])
+  {
+  }
+
+  Histogram(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /// @return The number of buckets, including the overflow bucket.
+  unsigned
+  size() const
+  {
+    return _n_buckets;
+  }
+
+  /** Bucket for a value.
+   *
+   * @param value Value.
+   * @return The index of the bucket that counts @a value.
+   */
+  unsigned
+  bucket_for(uint64_t value) const
+  {
+    auto idx = this->log_bucket(value);
+    return idx < _lo ? 0 : idx > _hi ? _n_buckets - 1 : idx - _lo;
+  }
+
+  /** Upper bound of a bucket.
+   *
+   * @param idx Bucket index.
+   * @return The largest value counted in bucket @a idx, or @c NO_BOUND for the overflow bucket.
+   */
+  uint64_t
+  upper_bound(unsigned idx) const
+  {
+    if (idx + 1 >= _n_buckets) {
+      return NO_BOUND;
+    }
+    idx += _lo;
+    uint64_t const sub = uint64_t(1) << _precision;
+    if (idx < sub) {
+      return idx;
+    }
+    unsigned shift = (idx >> _precision) - 1;
+    uint64_t lower = (sub + (idx & (sub - 1))) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+  }
+
+  /// Record @a value.
+  void
+  record(uint64_t value)
+  {
+    auto shard = shard_idx();
+    this->counter(shard, this->bucket_for(value)).fetch_add(1, std::memory_order_relaxed);
+    this->counter(shard, _n_buckets).fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /** Move the counts to the caller.
+   *
+   * @param [in,out] counts Count per bucket, added to. Resized to @c size() if needed.
+   * @param [in,out] sum Sum of recorded values, added to.
+   *
+   * The counts in @a this are reset. Values recorded concurrently are counted either now or in a
+   * later drain. The sum wraps on overflow.
+   */
+  void
+  drain(std::vector<uint64_t> &counts, uint64_t &sum)
+  {
+    counts.resize(_n_buckets, 0);
+    for (unsigned shard = 0; shard < N_SHARDS; ++shard) {
+      for (unsigned idx = 0; idx < _n_buckets; ++idx) {
+        counts[idx] += this->counter(shard, idx).exchange(0, std::memory_order_relaxed);
+      }
+      sum += this->counter(shard, _n_buckets).exchange(0, std::memory_order_relaxed);
+    }
+  }
+
+protected:
+  /// A cache line of counters.
+  struct alignas(64) Line {
+    static constexpr unsigned N = 64 / sizeof(std::atomic<uint64_t>); ///< Counters per line.
+    std::array<std::atomic<uint64_t>, N> _n{};
+  };
+
+  unsigned _precision;   ///< Bits of sub-bucket per power of two.
+  unsigned _lo;          ///< Log bucket for the first bucket.
+  unsigned _hi;          ///< Log bucket for the last bucket before overflow.
+  unsigned _n_buckets;   ///< Number of buckets.
+  unsigned _shard_lines; ///< Cache lines per shard.
+  /// Counters, @a _shard_lines per shard. The buckets of a shard are followed by the sum of values.
+  std::unique_ptr<Line[]> _lines;
+
+  /// @return Counter @a idx in @a shard, where @a _n_buckets is the sum.
+  std::atomic<uint64_t> &
+  counter(unsigned shard, unsigned idx)
+  {
+    return _lines[shard * _shard_lines + idx / Line::N]._n[idx % Line::N];
+  }
+
+  /** Log-linear bucket index for all values.
+   *
+   * @param value Value.
+   * @return Index, where buckets are 2^precision per power of two.
+   */
+  unsigned
+  log_bucket(uint64_t value) const
+  {
+    if (value < (uint64_t(1) << _precision)) {
+      return value;
+    }
+    unsigned shift = (63 - __builtin_clzll(value)) - _precision;
+    return (shift << _precision) + (value >> shift);
+  }
+
+  /// @return The shard for the current thread.
+  static unsigned
+  shard_idx()
+  {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned idx = next++ % N_SHARDS;
+    return idx;
+  }
+};
@@ -63,6 +63,13 @@ public:
   /// @return The number of capture groups in the expression.
   size_t capture_count() const;
 
+  /// @return The compiled expression.
+  pcre2_code *
+  code() const
+  {
+    return _rxp.get();
+  }
+
   /// Regular expression options.
   union Options {
     unsigned int all; ///< All of the flags.
@@ -0,0 +1,226 @@
+/** @file
+ *  Streaming text substitution.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifndef PCRE2_CODE_UNIT_WIDTH
+#define PCRE2_CODE_UNIT_WIDTH 8
+#endif
+#include <pcre2.h>
+
+#include <swoc/MemSpan.h>
+#include <swoc/TextView.h>
+
+/** Apply substitutions to text that arrives in chunks.
+ *
+ * Each rule matches a literal string or a regular expression and the match is replaced by fixed
+ * text. At each point the leftmost match of any rule is used, with earlier rules preferred if
+ * matches start at the same place. Text that might be the start of a match at the end of a chunk
+ * is carried over to the next chunk, but no more than the carry limit. A match that would be
+ * longer than that may be missed if it spans a chunk boundary. Such a possible match is dropped
+ * and the other rules are still applied to the text it covered, so their matches do not depend
+ * on how the text is split in to chunks. Nothing else is buffered, output is generated as soon as
+ * it is known to not be part of a match.
+ *
+ * Regular expressions use partial matching to detect a possible match at the end of a chunk, and
+ * zero length matches are ignored.
+ */
+class StreamRewriter
+{
+  using self_type = StreamRewriter; ///< Self reference type.
+
+public:
+  /// Default limit for text carried between chunks.
+  static constexpr size_t DEFAULT_CARRY = 4096;
+
+  /// A substitution.
+  struct Rule {
+    swoc::TextView _match;      ///< Literal text to match, if @a _rxp is @c nullptr.
+    pcre2_code *_rxp = nullptr; ///< Regular expression to match.
+    swoc::TextView _replace;    ///< Replacement text.
+  };
+
+  /** Construct.
+   *
+   * @param rules Substitutions.
+   * @param carry_max Maximum text carried between chunks.
+   *
+   * The memory for @a rules must remain valid for the lifetime of @a this.
+   */
+  explicit StreamRewriter(swoc::MemSpan<Rule const> rules, size_t carry_max = DEFAULT_CARRY)
+    : _rules(rules), _carry_max(carry_max), _match_data(pcre2_match_data_create(1, nullptr)), _found(rules.size())
+  {
+  }
+
+  StreamRewriter(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  ~StreamRewriter() { pcre2_match_data_free(_match_data); }
+
+  /** Process a chunk of text.
+   *
+   * @param input The text.
+   * @param eos @c true if this is the last chunk.
+   * @param out Output functor, called with views of output text, in order.
+   *
+   * If @a eos is @c true all remaining text is output.
+   */
+  template <typename F> void write(swoc::TextView input, bool eos, F &&out);
+
+  /// @return The largest amount of text that has been held over at once.
+  size_t
+  peak_carry() const
+  {
+    return _peak_carry;
+  }
+
+protected:
+  swoc::MemSpan<Rule const> _rules; ///< Substitutions.
+  size_t _carry_max;                ///< Limit for @a _carry.
+  pcre2_match_data *_match_data;    ///< Match data for regular expressions.
+  std::string _carry;               ///< Text held over from the previous chunk.
+  size_t _peak_carry = 0;           ///< Largest carry so far.
+
+  static constexpr size_t NPOS = swoc::TextView::npos;
+
+  /// Result of a search for a rule.
+  struct Found {
+    bool _valid_p   = false; ///< Search has been done.
+    size_t _start   = NPOS;  ///< Start of match.
+    size_t _end     = NPOS;  ///< End of match.
+    size_t _partial = NPOS;  ///< Start of possible match.
+  };
+  /// Most recent search results, per rule, so that rules are not searched again until passed.
+  std::vector<Found> _found;
+
+  /** Find a match.
+   *
+   * @param rule Rule to apply.
+   * @param src Text to search.
+   * @param pos Offset to start the search.
+   * @param eos @c true if there is no more text after @a src.
+   * @param [out] partial Start of a possible match at the end of @a src, if earlier than the current value.
+   * @return The start and end of the match, or @c NPOS if not found.
+   */
+  std::pair<size_t, size_t> find(Rule const &rule, swoc::TextView src, size_t pos, bool eos, size_t &partial);
+};
+
+inline std::pair<size_t, size_t>
+StreamRewriter::find(Rule const &rule, swoc::TextView src, size_t pos, bool eos, size_t &partial)
+{
+  if (rule._rxp) {
+    while (pos <= src.size()) {
+      auto rc = pcre2_match(rule._rxp, reinterpret_cast<PCRE2_SPTR>(src.data()), src.size(), pos, eos ? 0 : PCRE2_PARTIAL_HARD,
+                            _match_data, nullptr);
+      auto ovector = pcre2_get_ovector_pointer(_match_data);
+      if (rc >= 0) {
+        if (ovector[1] > ovector[0]) {
+          return {ovector[0], ovector[1]};
+        }
+        pos = ovector[0] + 1; // ignore empty matches.
+        continue;
+      } else if (rc == PCRE2_ERROR_PARTIAL) {
+        partial = std::min<size_t>(partial, ovector[0]);
+      }
+      break;
+    }
+    return {NPOS, NPOS};
+  }
+
+  if (rule._match.empty()) {
+    return {NPOS, NPOS};
+  }
+  if (auto idx = src.find(rule._match, pos); idx != NPOS) {
+    return {idx, idx + rule._match.size()};
+  }
+  if (!eos) { // Look for the longest suffix of @a src that is a prefix of the match.
+    for (size_t n = std::min(rule._match.size() - 1, src.size() - std::min(pos, src.size())); n > 0; --n) {
+      if (src.suffix(n) == rule._match.prefix(n)) {
+        partial = std::min(partial, src.size() - n);
+        break;
+      }
+    }
+  }
+  return {NPOS, NPOS};
+}
+
+template <typename F>
+void
+StreamRewriter::write(swoc::TextView input, bool eos, F &&out)
+{
+  swoc::TextView src = input;
+  bool carry_p       = !_carry.empty();
+  if (carry_p) { // need contiguous text to match across the boundary.
+    _carry.append(input.data(), input.size());
+    src = _carry;
+  }
+
+  size_t emitted = 0; // Text before this has been output.
+  size_t pos     = 0; // Search position.
+  size_t partial = NPOS;
+  // A possible match that starts before this is too long to carry.
+  size_t const limit = eos ? 0 : src.size() - std::min(src.size(), _carry_max);
+  for (auto &found : _found) {
+    found._valid_p = false; // different text, must search again.
+  }
+  while (pos < src.size()) {
+    size_t start = NPOS, end = NPOS;
+    Rule const *match = nullptr;
+    partial           = NPOS;
+    for (size_t idx = 0; idx < _rules.size(); ++idx) {
+      auto &found = _found[idx];
+      if (!found._valid_p || found._start < pos) { // previous result was passed, search again.
+        found._valid_p                     = true;
+        found._partial                     = NPOS;
+        std::tie(found._start, found._end) = this->find(_rules.begin()[idx], src, pos, eos, found._partial);
+        if (found._partial < limit) {
+          // Drop the possible match - look for a complete match from there, or a later possible match.
+          size_t ignored                     = NPOS;
+          std::tie(found._start, found._end) = this->find(_rules.begin()[idx], src, found._partial, true, ignored);
+          found._partial                     = NPOS;
+          if (found._start >= limit) {
+            std::tie(found._start, found._end) = this->find(_rules.begin()[idx], src, limit, false, found._partial);
+          }
+        }
+      }
+      partial = std::min(partial, found._partial);
+      if (found._start < start) {
+        start = found._start;
+        end   = found._end;
+        match = _rules.begin() + idx;
+      }
+    }
+    // No match, or a possible match that starts earlier and needs more text.
+    if (match == nullptr || partial < start) {
+      break;
+    }
+    out(src.substr(emitted, start - emitted));
+    out(match->_replace);
+    emitted = pos = end;
+    partial       = NPOS;
+  }
+
+  size_t keep = src.size(); // Output up to here.
+  if (!eos && partial != NPOS) {
+    keep = std::max(partial, emitted); // @a partial is never before @a limit.
+  }
+  if (keep > emitted) {
+    out(src.substr(emitted, keep - emitted));
+  }
+
+  if (carry_p) {
+    _carry.erase(0, keep);
+  } else {
+    _carry.assign(src.data() + keep, src.size() - keep);
+  }
+  _peak_carry = std::max(_peak_carry, _carry.size());
+}
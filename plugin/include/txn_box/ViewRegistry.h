@@ -0,0 +1,111 @@
+/** @file
+ *  Reference counted registry of items keyed by a view of memory.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+/** Items keyed by a view, with a reference count per view.
+ *
+ * @tparam T Item type, constructed from the size of the view.
+ *
+ * A view is identified by its memory and size, not by value. The same view can be registered by
+ * more than one owner, e.g. because identical strings are interned and so share memory. Each
+ * registration must be matched by a release and the item is removed only when the last owner
+ * releases it. This does no locking, the caller must serialize access.
+ */
+template <typename T> class ViewRegistry
+{
+  using self_type = ViewRegistry; ///< Self reference type.
+
+public:
+  /** Add a reference to @a view.
+   *
+   * @param view View to register.
+   * @return The item for @a view.
+   *
+   * The item is created if this is the first reference.
+   */
+  T &
+  acquire(std::string_view view)
+  {
+    auto &entry = _items[Key{view.data(), view.size()}];
+    if (entry._count++ == 0) {
+      entry._item = std::make_unique<T>(view.size());
+    }
+    return *entry._item;
+  }
+
+  /** Drop a reference to @a view.
+   *
+   * @param view View to release.
+   * @return The item if this was the last reference, otherwise @c nullptr.
+   *
+   * The item is returned so that it can be destroyed after the caller releases any lock.
+   */
+  std::unique_ptr<T>
+  release(std::string_view view)
+  {
+    std::unique_ptr<T> zret;
+    if (auto spot = _items.find(Key{view.data(), view.size()}); spot != _items.end()) {
+      if (--spot->second._count == 0) {
+        zret = std::move(spot->second._item);
+        _items.erase(spot);
+      }
+    }
+    return zret;
+  }
+
+  /// @return The item for @a view, or @c nullptr if it is not registered.
+  T *
+  find(std::string_view view) const
+  {
+    auto spot = _items.find(Key{view.data(), view.size()});
+    return spot == _items.end() ? nullptr : spot->second._item.get();
+  }
+
+  /// @return The number of references to @a view.
+  unsigned
+  count(std::string_view view) const
+  {
+    auto spot = _items.find(Key{view.data(), view.size()});
+    return spot == _items.end() ? 0 : spot->second._count;
+  }
+
+  /// @return The number of registered views.
+  size_t
+  size() const
+  {
+    return _items.size();
+  }
+
+protected:
+  /// Memory and size of a view.
+  using Key = std::pair<char const *, size_t>;
+
+  /// Hash for @c Key.
+  struct Hash {
+    size_t
+    operator()(Key const &key) const
+    {
+      return std::hash<char const *>()(key.first) ^ (key.second * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+
+  /// Registered item.
+  struct Entry {
+    unsigned _count = 0;      ///< Number of references.
+    std::unique_ptr<T> _item; ///< The item.
+  };
+
+  std::unordered_map<Key, Entry, Hash> _items; ///< Registered items.
+};
@@ -932,6 +932,24 @@ template <typename T> let<T>::~let()
   _var = _value;
 }
 
+/** Decide whether to sample an event.
+ *
+ * @param n Sample rate.
+ * @return @c true for about 1 in @a n calls.
+ *
+ * This is random, rather than every @a n th call, so that the sample is not skewed by the pattern
+ * of events. The generator state is per thread to avoid contention.
+ */
+inline bool
+sample_p(unsigned n)
+{
+  thread_local uint64_t state = 0x9E3779B97F4A7C15; // any non-zero seed.
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state % n == 0;
+}
+
 // BufferWriter support.
 namespace swoc
 {
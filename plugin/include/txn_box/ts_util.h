@@ -8,10 +8,19 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <type_traits>
 #include <variant>
 
 #include "txn_box/common.h"
+#include "txn_box/Histogram.h"
+#include "txn_box/ViewRegistry.h"
 #include <swoc/swoc_file.h>
 #include <swoc/MemArena.h>
 
@@ -19,7 +28,14 @@
 
 constexpr char const DEBUG_TAG[] = "txn_box";
 
-#if TS_VERSION_MAJOR >= 10
+#if defined(TXN_BOX_STANDALONE)
+
+// Offline tools built from the plugin sources don't have TS debug controls, the tool provides this.
+void txn_box_standalone_debug(char const *fmt, ...);
+
+#define TS_DBG(...) txn_box_standalone_debug(__VA_ARGS__)
+
+#elif TS_VERSION_MAJOR >= 10
 
 extern DbgCtl txn_box_dbg_ctl;
 
@@ -919,6 +935,298 @@ TaskHandle PerformAsTask(std::function<void()> &&task);
 
 TaskHandle PerformAsTaskEvery(std::function<void()> &&task, std::chrono::milliseconds period);
 
+/** Shared file change detection.
+ *
+ * Rather than each file backed directive polling its file, files are registered here and a single
+ * thread watches all of them. When a file changes, the callback for that file is scheduled on the
+ * task pool. This uses inotify if available, watching the directory containing the file so that
+ * files replaced by rename are detected. Otherwise the files are polled for a change in the
+ * modified time every @c POLL_PERIOD.
+ *
+ * The callback may be invoked for changes that do not alter the content and should check before
+ * reloading.
+ */
+class FileWatch
+{
+  using self_type = FileWatch; ///< Self reference type.
+public:
+  using Callback = std::function<void()>; ///< Change notification.
+
+  /// Time between checks if polling.
+  static constexpr std::chrono::seconds POLL_PERIOD{5};
+
+  /// The singleton instance.
+  static self_type &instance();
+
+  /** Watch a file for changes.
+   *
+   * @param path Absolute path to the file.
+   * @param f Callback to schedule if the file changes.
+   * @return Identifier for the watch.
+   */
+  unsigned watch(swoc::file::path const &path, Callback &&f);
+
+  /** Stop watching.
+   *
+   * @param id Identifier from @c watch.
+   *
+   * The callback may still be invoked if it was scheduled before this call.
+   */
+  void unwatch(unsigned id);
+
+protected:
+  /// A watched file.
+  struct Item {
+    unsigned _id;                                 ///< Identifier.
+    swoc::file::path _path;                       ///< Path to file.
+    std::string _name;                            ///< File name, without directory.
+    int _wd = -1;                                 ///< inotify watch descriptor of the directory.
+    std::chrono::system_clock::time_point _mtime; ///< Last modified time, if polling.
+    Callback _f;                                  ///< Change callback.
+  };
+
+  std::mutex _mutex;        ///< Protect @a _items.
+  std::list<Item> _items;   ///< Watched files.
+  unsigned _next_id = 1;    ///< Next identifier.
+  int _fd           = -1;   ///< inotify file descriptor, -1 if polling.
+  bool _running_p   = false; ///< Watch thread started.
+
+  FileWatch(); ///< Singleton.
+
+  /// Watch thread.
+  void run();
+
+  /// Handle inotify events.
+  void process_events();
+
+  /// Check for modified files by polling.
+  void poll_files();
+};
+
+/** Shared body content.
+ *
+ * Content that is used as a body for many transactions, such as a text block, can be published
+ * here. On first use it is copied in to an @c IOBuffer and after that transactions reference the
+ * blocks of that buffer rather than copying the content. The blocks are reference counted so
+ * withdrawing content does not affect transactions that already use it.
+ *
+ * Content is identified by its view, i.e. the same memory and size, not by value. The same view
+ * can be published more than once, e.g. by identical literals in different configurations which
+ * share interned memory, and remains published until it has been withdrawn as many times.
+ */
+class SharedBody
+{
+  using self_type = SharedBody; ///< Self reference type.
+public:
+  /// The singleton instance.
+  static self_type &instance();
+
+  /** Publish content.
+   *
+   * @param view The content.
+   *
+   * The memory for @a view must be valid until it is withdrawn. Each publication must be matched
+   * by a call to @c withdraw.
+   */
+  void publish(swoc::TextView view);
+
+  /** Withdraw content.
+   *
+   * @param view The content, as published.
+   */
+  void withdraw(swoc::TextView view);
+
+  /** Append content without copying.
+   *
+   * @param buff Buffer to append to.
+   * @param view The content.
+   * @return @c true if @a view is published and was appended, @c false if not.
+   */
+  bool append(TSIOBuffer buff, swoc::TextView view);
+
+protected:
+  /// Published content.
+  struct Item {
+    size_t _size;                        ///< Size of the content.
+    std::once_flag _once;                ///< Control creating the buffer.
+    TSIOBuffer _buff         = nullptr;  ///< Buffer with a copy of the content.
+    TSIOBufferReader _reader = nullptr;  ///< Reader for @a _buff, never consumed.
+
+    explicit Item(size_t size) : _size(size) {}
+    ~Item();
+  };
+
+  std::shared_mutex _mutex;   ///< Protect @a _items.
+  ViewRegistry<Item> _items; ///< Published content.
+
+  SharedBody() = default; ///< Singleton.
+};
+
+/** Base for stats accumulated in the plugin and added to plugin stats periodically.
+ *
+ * Each instance has a flush period, by default @c FLUSH_PERIOD, and a stat can lag by up to that
+ * period. There is a single periodic task for each distinct period which flushes all active
+ * instances with that period. Subclasses must call @c withdraw in their destructor so the task
+ * does not flush a partially destroyed instance.
+ */
+class FlushedStat
+{
+  using self_type = FlushedStat; ///< Self reference type.
+public:
+  /// Time between adding counts to stats.
+  static constexpr std::chrono::milliseconds FLUSH_PERIOD{1000};
+
+  FlushedStat() = default;
+  FlushedStat(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+  virtual ~FlushedStat() = default;
+
+protected:
+  /// Add the accumulated values to the stats.
+  /// This is serialized with respect to other flushes.
+  virtual void flush() = 0;
+
+  /// Add to the active instances, starting the flush task for @a period if needed.
+  void enroll(std::chrono::milliseconds period = FLUSH_PERIOD);
+  /// Remove from the active instances and do a final flush.
+  void withdraw();
+
+  std::chrono::milliseconds _period{FLUSH_PERIOD}; ///< Flush period.
+
+  /// Active instances with the same flush period.
+  struct Group {
+    std::unordered_set<self_type *> _stats; ///< Active instances.
+    TaskHandle _task;                       ///< Flush task, started on first use.
+  };
+  /// Active instances, for the flush tasks.
+  struct Registry {
+    std::mutex _mutex;                                  ///< Protect @a _groups.
+    std::map<std::chrono::milliseconds, Group> _groups; ///< Instances by flush period.
+  };
+  /// @return The registry singleton.
+  static Registry &registry();
+};
+
+/** A plugin stat updated through per thread counters.
+ *
+ * Incrementing touches only the counter in a shard chosen by thread, so threads rarely contend.
+ * Remaining counts are added when an instance is destroyed.
+ */
+class ShardedStat : public FlushedStat
+{
+  using self_type = ShardedStat; ///< Self reference type.
+public:
+  /// Number of counter shards.
+  static constexpr unsigned N_SHARDS = 32;
+
+  ~ShardedStat() override;
+
+  /** Create an instance for a stat.
+   *
+   * @param name Full name of the stat.
+   * @param period Flush period.
+   * @param value Initial value.
+   * @param persistent_p Make the stat persistent.
+   * @return An instance, or errors if the stat could not be created.
+   *
+   * The stat is created if it does not exist, otherwise @a value and @a persistent_p are ignored.
+   */
+  static swoc::Rv<std::unique_ptr<self_type>> make(swoc::TextView const &name, std::chrono::milliseconds period = FLUSH_PERIOD,
+                                                   int value = 0, bool persistent_p = false);
+
+  /// @return The stat index.
+  int
+  index() const
+  {
+    return _idx;
+  }
+
+  /// Add @a n to the counter for the current thread.
+  void
+  increment(int64_t n = 1)
+  {
+    _shards[shard()]._n.fetch_add(n, std::memory_order_relaxed);
+  }
+
+protected:
+  /// Counter, on its own cache line.
+  struct alignas(64) Shard {
+    std::atomic<int64_t> _n{0};
+  };
+
+  int _idx; ///< Stat index.
+  std::array<Shard, N_SHARDS> _shards; ///< Counters.
+
+  explicit ShardedStat(int idx) : _idx(idx) {}
+
+  /// @return The shard for the current thread.
+  static unsigned
+  shard()
+  {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned idx = next++ % N_SHARDS;
+    return idx;
+  }
+
+  void flush() override;
+};
+
+/** A histogram exposed as a family of plugin stats.
+ *
+ * For a stat name @c N the stats are
+ * - @c N.count - the number of values recorded.
+ * - @c N.sum - the sum of the values recorded.
+ * - @c N.bucket.B - the number of values in the bucket with upper bound @c B.
+ * - @c N.bucket.inf - the number of values larger than the upper bound of the last bucket.
+ *
+ * Values are recorded lock free in to per thread buckets, see @c Histogram.
+ */
+class HistogramStat : public FlushedStat
+{
+  using self_type = HistogramStat; ///< Self reference type.
+public:
+  ~HistogramStat() override;
+
+  /** Create an instance.
+   *
+   * @param name Base name of the stats.
+   * @param min Smallest value of interest.
+   * @param max Largest value of interest.
+   * @param precision Bits of sub-bucket in each power of two range.
+   * @param persistent_p Make the stats persistent.
+   * @param period Flush period.
+   * @return An instance, or errors if the stats could not be created.
+   */
+  static swoc::Rv<std::unique_ptr<self_type>> make(swoc::TextView const &name, uint64_t min, uint64_t max,
+                                                   unsigned precision, bool persistent_p,
+                                                   std::chrono::milliseconds period = FLUSH_PERIOD);
+
+  /// Record @a value.
+  void
+  record(uint64_t value)
+  {
+    _histogram.record(value);
+  }
+
+  /// @return The stat index of the count of values.
+  int
+  count_index() const
+  {
+    return _count_idx;
+  }
+
+protected:
+  Histogram _histogram;            ///< Per thread buckets.
+  int _count_idx = -1;             ///< Stat for the count of values.
+  int _sum_idx   = -1;             ///< Stat for the sum of values.
+  std::vector<int> _bucket_idx;    ///< Stat per bucket.
+  std::vector<uint64_t> _counts;   ///< Scratch space for flushing.
+
+  HistogramStat(uint64_t min, uint64_t max, unsigned precision) : _histogram(min, max, precision) {}
+
+  void flush() override;
+};
+
 inline HeapObject::HeapObject(TSMBuffer buff, TSMLoc loc) : _buff(buff), _loc(loc) {}
 
 inline bool
@@ -104,6 +104,14 @@ YAML::Node yaml_merge(YAML::Node root);
 
 swoc::Rv<YAML::Node> yaml_load(swoc::file::path const &path);
 
+/** Parse YAML content that was loaded from a file.
+ *
+ * @param content The file content.
+ * @param path Path to the file, used for error reporting.
+ * @return The root node, with merge keys resolved, or errors.
+ */
+swoc::Rv<YAML::Node> yaml_parse(std::string const &content, swoc::file::path const &path);
+
 namespace YAML
 {
 # if !defined(YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66)
@@ -16,6 +16,7 @@
 #include "txn_box/Directive.h"
 #include "txn_box/Config.h"
 #include "txn_box/Context.h"
+#include "txn_box/ts_util.h"
 
 using swoc::TextView;
 using namespace swoc::literals;
@@ -72,6 +73,7 @@ Comparison::load(Config &cfg, YAML::Node node)
       if (!errata.is_ok()) {
         return std::move(errata);
       }
+      cfg.note_comparison(*handle);
 
       return std::move(handle);
     }
@@ -213,6 +215,16 @@ protected:
    */
   virtual bool operator()(Context &ctx, TextView const &text, TextView active) const = 0;
 
+  /** Count a case sensitive literal comparison as a string accelerator candidate.
+   *
+   * @param counters Accelerator counters.
+   *
+   * Only exact, prefix, and suffix comparisons can use the string accelerator, and only if the
+   * value is known when the configuration is loaded. This is only counted, for diagnostics, as
+   * @c StringAccelerator is not yet used for evaluation and so @c accelerate is not overridden.
+   */
+  void count_string_candidate(Accelerator::Counters &counters) const;
+
   struct expr_validator {
     bool
     operator()(std::monostate const &)
@@ -261,9 +273,24 @@ Cmp_LiteralString::operator()(Context &ctx, feature_type_for<STRING> const &feat
   return false;
 }
 
+void
+Cmp_LiteralString::count_string_candidate(Accelerator::Counters &counters) const
+{
+  if (_expr.is_literal()) {
+    ++counters[Accelerator::BY_STRING];
+  }
+}
+
 /// Match entire string.
 class Cmp_MatchStd : public Cmp_LiteralString
 {
+public:
+  void
+  can_accelerate(Accelerator::Counters &counters) const override
+  {
+    this->count_string_candidate(counters);
+  }
+
 protected:
   using self_type  = Cmp_MatchStd;
   using super_type = Cmp_LiteralString;
@@ -310,6 +337,13 @@ Cmp_MatchNC::operator()(Context &ctx, TextView const &text, TextView active) con
 /// Compare the active feature to a string suffix.
 class Cmp_Suffix : public Cmp_LiteralString
 {
+public:
+  void
+  can_accelerate(Accelerator::Counters &counters) const override
+  {
+    this->count_string_candidate(counters);
+  }
+
 protected:
   using self_type  = Cmp_Suffix;
   using super_type = Cmp_LiteralString;
@@ -355,6 +389,13 @@ Cmp_SuffixNC::operator()(Context &ctx, TextView const &text, TextView active) co
 
 class Cmp_Prefix : public Cmp_LiteralString
 {
+public:
+  void
+  can_accelerate(Accelerator::Counters &counters) const override
+  {
+    this->count_string_candidate(counters);
+  }
+
 protected:
   using self_type  = Cmp_Prefix;
   using super_type = Cmp_LiteralString;
@@ -1724,6 +1765,29 @@ ComparisonGroupBase::load(Config &cfg, YAML::Node node)
   return {};
 }
 
+Rv<std::unique_ptr<ts::ShardedStat>>
+ComparisonGroupBase::load_stat(Config &cfg, YAML::Node node)
+{
+  auto stat_node = node[STAT_KEY];
+  if (!stat_node) {
+    return std::unique_ptr<ts::ShardedStat>{};
+  }
+  auto &&[expr, errata]{cfg.parse_expr(stat_node)};
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing "{}" key at {}.)", STAT_KEY, stat_node.Mark());
+    return std::move(errata);
+  }
+  if (!expr.is_literal() || !expr.result_type().can_satisfy(STRING)) {
+    return Errata(S_ERROR, R"("{}" value at {} must be a literal string.)", STAT_KEY, stat_node.Mark());
+  }
+  auto name = std::get<IndexFor(STRING)>(std::get<Expr::LITERAL>(expr._raw));
+  if (name.empty()) {
+    return Errata(S_ERROR, R"("{}" value at {} must be a non-empty literal string.)", STAT_KEY, stat_node.Mark());
+  }
+  std::string full_name;
+  return ts::ShardedStat::make(swoc::bwprint(full_name, "plugin.{}.{}", Config::PLUGIN_TAG, name));
+}
+
 Rv<Comparison::Handle>
 ComparisonGroupBase::load_cmp(Config &cfg, YAML::Node node)
 {
@@ -20,6 +20,7 @@
 #include "txn_box/Directive.h"
 #include "txn_box/Extractor.h"
 #include "txn_box/Modifier.h"
+#include "txn_box/Comparison.h"
 #include "txn_box/Expr.h"
 #include "txn_box/Config.h"
 #include "txn_box/Context.h"
@@ -99,6 +100,10 @@ Config::~Config()
     f._f(f._ptr);
     std::destroy_at(&f._f); // clean up the cleaner too, just in case.
   }
+  auto &interner = StringInterner::instance();
+  for (auto const &text : _interned) {
+    interner.release(text);
+  }
 }
 
 template <typename F> struct on_scope_exit {
@@ -181,23 +186,102 @@ Config::localize(Feature &feature)
 }
 
 TextView &
-Config::localize(TextView &text, LocalOpt opt)
+Config::localize(TextView &text, LocalOpt)
 {
+  // Interned strings are always null terminated so @a LocalOpt doesn't matter.
   if (text.size()) {
-    if (LOCAL_CSTR == opt) {
-      auto span{_arena.alloc(text.size() + 1).rebind<char>()};
-      memcpy(span, text);
-      span[text.size()] = 0;
-      text              = span.subspan(0, text.size());
+    if (auto spot = _interned.find(text); spot != _interned.end()) {
+      text = *spot;
     } else {
-      auto span{_arena.alloc(text.size()).rebind<char>()};
-      memcpy(span, text);
-      text = span;
+      text = StringInterner::instance().add(text);
+      _interned.insert(text);
+      _interned_size += text.size();
     }
   }
   return text;
 };
 
+BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &, Config const &cfg)
+{
+  w.print("arena {} bytes, strings {} bytes in {} distinct, {} directives", cfg.arena_size(), cfg.string_size(), cfg.string_count(),
+          cfg.directive_count());
+  for (unsigned idx = IndexFor(Hook::POST_LOAD); idx < std::tuple_size<Hook>::value; ++idx) {
+    if (auto n = cfg.hook_directives(Hook(idx)).size(); n > 0) {
+      w.print(" {}:{}", Hook(idx), n);
+    }
+  }
+  return w;
+}
+
+void
+Config::note_comparison(Comparison const &cmp)
+{
+  ++_cmp_count;
+  cmp.can_accelerate(_accl_counters);
+}
+
+size_t
+Config::directive_count() const
+{
+  size_t zret = 0;
+  for (auto const &info : _drtv_info) {
+    zret += info._count;
+  }
+  return zret;
+}
+/* ------------------------------------------------------------------------------------ */
+StringInterner &
+StringInterner::instance()
+{
+  // Never destroyed so that configurations destroyed during process exit can still release.
+  static self_type *instance = new self_type;
+  return *instance;
+}
+
+TextView
+StringInterner::add(TextView text)
+{
+  std::lock_guard lock(_mutex);
+  if (auto spot = _map.find(text); spot != _map.end()) {
+    ++spot->second._refs;
+    return spot->first;
+  }
+  std::unique_ptr<char[]> buff{new char[text.size() + 1]};
+  memcpy(buff.get(), text.data(), text.size());
+  buff[text.size()] = '\0';
+  std::string_view key{buff.get(), text.size()};
+  auto &item = _map[key];
+  item._text = std::move(buff);
+  item._refs = 1;
+  _size += text.size();
+  return key;
+}
+
+void
+StringInterner::release(TextView text)
+{
+  std::lock_guard lock(_mutex);
+  if (auto spot = _map.find(text); spot != _map.end() && --spot->second._refs == 0) {
+    _size -= spot->first.size();
+    _map.erase(spot); // @a spot->first refers to the item text, don't use after this.
+  }
+}
+
+size_t
+StringInterner::count() const
+{
+  std::lock_guard lock(_mutex);
+  return _map.size();
+}
+
+size_t
+StringInterner::size() const
+{
+  std::lock_guard lock(_mutex);
+  return _size;
+}
+
 Rv<ActiveType>
 Config::validate(Extractor::Spec &spec)
 {
@@ -526,6 +610,11 @@ Config::load_directive(YAML::Node const &drtv_node)
       }
       drtv->_rtti = rtti;
 
+      if (_profile_sample > 0) {
+        auto profile   = ProfileDirective::make(*this, std::move(drtv), name, drtv_node.Mark());
+        profile->_rtti = rtti;
+        return std::move(profile);
+      }
       return std::move(drtv);
     }
   }
@@ -674,36 +763,115 @@ Config::load_file(swoc::file::path const &cfg_path, TextView cfg_key, YamlCache
     iter->second.add_cfg_key(cfg_key);
   }
 
-  YAML::Node root;
   // Try loading and parsing the file.
-  if (cache) {
-    if (auto cache_spot = cache->find(cfg_path); cache_spot != cache->end()) {
-      root = cache_spot->second;
-    }
-  }
-
-  if (root.IsNull()) {
-    auto &&[yaml_node, yaml_errata]{yaml_load(cfg_path)};
-    if (!yaml_errata.is_ok()) {
-      yaml_errata.note(R"(While loading file "{}".)", cfg_path);
-      return std::move(yaml_errata);
-    }
-    root = yaml_node;
-    if (cache) {
-      cache->emplace(cfg_path, root);
-    }
+  auto t0 = std::chrono::steady_clock::now();
+  auto &&[root, yaml_errata]{cache ? cache->load(cfg_path) : yaml_load(cfg_path)};
+  if (!yaml_errata.is_ok()) {
+    yaml_errata.note(R"(While loading file "{}".)", cfg_path);
+    return std::move(yaml_errata);
   }
 
   // Process the YAML data.
+  auto t1     = std::chrono::steady_clock::now();
+  auto save   = _cur_file;
+  _cur_file   = this->localize(cfg_path.view());
   auto errata = this->parse_yaml(root, cfg_key);
+  _cur_file   = save;
   if (!errata.is_ok()) {
     errata.note(R"(While parsing key "{}" in configuration file "{}".)", cfg_key, cfg_path);
     return errata;
   }
+  auto t2 = std::chrono::steady_clock::now();
+
+  // Split the time between YAML parsing and building the configuration, as they are tuned differently.
+  using us = std::chrono::microseconds;
+  ts::DebugMsg(R"(Loaded "{}":{} - YAML {} us, configuration {} us.)", cfg_path, cfg_key,
+               std::chrono::duration_cast<us>(t1 - t0).count(), std::chrono::duration_cast<us>(t2 - t1).count());
 
   return {};
 }
 /* ------------------------------------------------------------------------------------ */
+Rv<YAML::Node>
+Config::YamlCache::load(swoc::file::path const &path)
+{
+  auto spot = _map.find(path);
+  if (spot != _map.end() && spot->second._generation == _generation) {
+    ++_reuse_count;
+    return spot->second._root;
+  }
+
+  std::error_code ec;
+  auto fs = swoc::file::status(path, ec);
+  if (ec) {
+    if (spot != _map.end()) {
+      _map.erase(spot);
+    }
+    return Errata(S_ERROR, R"(Unable to access file "{}" - {}.)", path, ec);
+  }
+  auto mtime = swoc::file::last_write_time(fs);
+  auto size  = swoc::file::file_size(fs);
+
+  if (spot != _map.end()) {
+    auto &item = spot->second;
+    // Same stamp - presume it's the same content.
+    if (item._mtime == mtime && item._size == size) {
+      item._generation = _generation;
+      ++_reuse_count;
+      return item._root;
+    }
+  }
+
+  std::string content = swoc::file::load(path, ec);
+  if (ec) {
+    return Errata(S_ERROR, R"(Unable to load file "{}" - {}.)", path, ec);
+  }
+  auto hash = std::hash<std::string_view>{}(content);
+
+  if (spot != _map.end() && spot->second._hash == hash) {
+    // Touched but not changed - update the stamp and reuse the tree.
+    auto &item       = spot->second;
+    item._mtime      = mtime;
+    item._size       = size;
+    item._generation = _generation;
+    ++_reuse_count;
+    return item._root;
+  }
+
+  auto &&[root, errata]{yaml_parse(content, path)};
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+  ++_parse_count;
+  _map[path] = Item{root, mtime, size, hash, _generation};
+  return root;
+}
+
+void
+Config::YamlCache::advance()
+{
+  ++_generation;
+  _reuse_count = _parse_count = 0;
+}
+
+void
+Config::YamlCache::sweep()
+{
+  for (auto spot = _map.begin(), limit = _map.end(); spot != limit;) {
+    if (spot->second._generation != _generation) {
+      spot = _map.erase(spot);
+    } else {
+      ++spot;
+    }
+  }
+}
+
+void
+Config::YamlCache::clear()
+{
+  _map.clear();
+  _reuse_count = _parse_count = 0;
+}
+/* ------------------------------------------------------------------------------------ */
 Errata
 Config::load_file_glob(TextView pattern, swoc::TextView cfg_key, YamlCache *cache)
 {
@@ -744,6 +912,8 @@ Config::load_cli_args(Handle handle, swoc::MemSpan<char const *> argv, int arg_i
 {
   static constexpr TextView KEY_OPT    = "key";
   static constexpr TextView CONFIG_OPT = "config"; // An archaism for BC - take out someday.
+  static constexpr TextView PROFILE_OPT = "profile";
+  static constexpr TextView HOOK_TIME_OPT = "hook-time";
 
   TextView cfg_key{_hook == Hook::REMAP ? REMAP_ROOT_KEY : GLOBAL_ROOT_KEY};
   for (unsigned idx = arg_idx; idx < argv.count(); ++idx) {
@@ -769,6 +939,23 @@ Config::load_cli_args(Handle handle, swoc::MemSpan<char const *> argv, int arg_i
 
       if (arg.starts_with_nocase(KEY_OPT)) {
         cfg_key = value;
+      } else if (arg.starts_with_nocase(PROFILE_OPT)) {
+        TextView parsed;
+        auto n = swoc::svtou(value, &parsed);
+        if (parsed.size() != value.size()) {
+          return Errata(S_ERROR, "Arg {} is an option '{}' that requires an integer value but '{}' was found.", idx, arg, value);
+        }
+        _profile_sample = n;
+      } else if (arg.starts_with_nocase(HOOK_TIME_OPT)) {
+        TextView parsed;
+        auto n = swoc::svtou(value, &parsed);
+        if (parsed.size() != value.size()) {
+          return Errata(S_ERROR, "Arg {} is an option '{}' that requires an integer value but '{}' was found.", idx, arg, value);
+        }
+        if (_hook == Hook::REMAP) {
+          return Errata(S_ERROR, "Arg {} is an option '{}' that is valid only for the global plugin.", idx, arg);
+        }
+        _hook_time_sample = n; // process wide, applied by the plugin if the load succeeds.
       } else if (arg.starts_with_nocase(CONFIG_OPT)) {
         auto errata = this->load_file_glob(value, cfg_key, cache);
         if (!errata.is_ok()) {
@@ -7,6 +7,7 @@
 
 #include <swoc/MemSpan.h>
 #include <swoc/ArenaWriter.h>
+#include <swoc/bwf_std.h>
 
 #include "txn_box/Context.h"
 #include "txn_box/Config.h"
@@ -60,6 +61,10 @@ Context::Context(std::shared_ptr<Config> const &cfg) : _cfg(cfg)
     _ctx_store = _arena->alloc(reserved_size);
     memset(_ctx_store, 0); // Zero initialize it.
   }
+
+  if (auto n = hook_time_info()._sample.load(std::memory_order_acquire); n > 0) {
+    _hook_time_p = sample_p(n);
+  }
 }
 
 Context::~Context()
@@ -111,7 +116,9 @@ Context::invoke_callbacks()
 Errata
 Context::invoke_for_hook(Hook hook)
 {
-  _cur_hook = hook;
+  // Only read the clock if accounting for this transaction.
+  auto start = _hook_time_p ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+  _cur_hook  = hook;
   this->clear_cache();
 
   // Run the top level directives in the config first.
@@ -124,6 +131,9 @@ Context::invoke_for_hook(Hook hook)
   this->invoke_callbacks();
 
   _cur_hook = Hook::INVALID;
+  if (_hook_time_p) {
+    this->account_hook_time(hook, start);
+  }
 
   return {};
 }
@@ -131,6 +141,7 @@ Context::invoke_for_hook(Hook hook)
 Errata
 Context::invoke_for_remap(Config &rule_cfg, TSRemapRequestInfo *rri)
 {
+  auto start  = _hook_time_p ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
   _cur_hook   = Hook::REMAP;
   _remap_info = rri;
   this->clear_cache();
@@ -158,10 +169,75 @@ Context::invoke_for_remap(Config &rule_cfg, TSRemapRequestInfo *rri)
   // Revert from remap style invocation.
   _cur_hook   = Hook::INVALID;
   _remap_info = nullptr;
+  if (_hook_time_p) {
+    this->account_hook_time(Hook::REMAP, start);
+  }
 
   return {};
 }
 
+auto
+Context::hook_time_info() -> HookTime &
+{
+  static HookTime *info = new HookTime; // never destroyed, transactions may be active at exit.
+  return *info;
+}
+
+Errata
+Context::enable_hook_time(unsigned sample)
+{
+  // Nanoseconds, 1 bucket per power of 2 from 512 ns to 16 ms.
+  static constexpr uint64_t MIN       = 1000;
+  static constexpr uint64_t MAX       = 10000000;
+  static constexpr unsigned PRECISION = 0;
+  static constexpr std::array<Hook, 9> HOOKS{Hook::TXN_START, Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP,
+                                             Hook::PREQ,      Hook::URSP, Hook::PRSP,      Hook::TXN_CLOSE};
+
+  auto &info = hook_time_info();
+  std::lock_guard lock(info._mutex);
+  if (sample > 0 && !info._stats[IndexFor(HOOKS.back())]) { // first time enabled.
+    std::string name;
+    for (auto hook : HOOKS) {
+      swoc::bwprint(name, "plugin.{}.hook-time.{}", Config::PLUGIN_TAG, hook);
+      auto &&[stat, errata]{ts::HistogramStat::make(name, MIN, MAX, PRECISION, false)};
+      if (!errata.is_ok()) {
+        errata.note("While creating hook time stats.");
+        return std::move(errata);
+      }
+      info._stats[IndexFor(hook)] = std::move(stat);
+    }
+  }
+  // The stats must be visible before transactions check them.
+  info._sample.store(sample, std::memory_order_release);
+  return {};
+}
+
+void
+Context::account_hook_time(Hook hook, std::chrono::steady_clock::time_point start)
+{
+  auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  _hook_time[IndexFor(hook)] += delta;
+  if (auto &stat = hook_time_info()._stats[IndexFor(hook)]; stat) {
+    stat->record(delta.count());
+  }
+}
+
+std::chrono::nanoseconds
+Context::hook_time(Hook hook) const
+{
+  if (!_hook_time_p) {
+    return std::chrono::nanoseconds{-1};
+  }
+  if (hook == Hook::INVALID) {
+    std::chrono::nanoseconds total{0};
+    for (auto t : _hook_time) {
+      total += t;
+    }
+    return total;
+  }
+  return _hook_time[IndexFor(hook)];
+}
+
 void
 Context::operator()(swoc::BufferWriter &w, Extractor::Spec const &spec)
 {
@@ -5,11 +5,20 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <atomic>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include <swoc/Errata.h>
+#include <swoc/bwf_base.h>
 
 #include "txn_box/Directive.h"
 #include "txn_box/Config.h"
 #include "txn_box/Context.h"
+#include "txn_box/ts_util.h"
 
 using swoc::Errata;
 using swoc::Rv;
@@ -43,5 +52,71 @@ NilDirective::invoke(Context &)
   return {};
 }
 /* ------------------------------------------------------------------------------------ */
+namespace
+{
+/// @return The CPU cycle counter, or nanoseconds where that is not available.
+inline uint64_t
+cycle_count()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+} // namespace
+
+Directive::Handle
+ProfileDirective::make(Config &cfg, Handle &&drtv, TextView const &name, YAML::Mark const &mark)
+{
+  // Number of directive locations with stats created by this process.
+  static std::atomic<unsigned> Profiled{0};
+
+  // Stats are never removed, so on reload the same directive location uses the same stats and
+  // only new locations count against the limit.
+  std::string samples_name;
+  std::string cycles_name;
+  swoc::bwprint(samples_name, "plugin.{}.profile.{}:{}.{}.samples", Config::PLUGIN_TAG, cfg.current_file(), mark.line + 1, name);
+  swoc::bwprint(cycles_name, "plugin.{}.profile.{}:{}.{}.cycles", Config::PLUGIN_TAG, cfg.current_file(), mark.line + 1, name);
+  if (ts::plugin_stat_index(samples_name) < 0) {
+    if (auto n = Profiled++; n >= MAX_PROFILED) {
+      if (n == MAX_PROFILED) { // only complain once.
+        std::string text;
+        ts::Log_Warning(swoc::bwprint(text, "{}: profiling limit of {} directives reached, {} at {} and later directives are not profiled.",
+                                      Config::PLUGIN_TAG, MAX_PROFILED, name, mark));
+      }
+      return std::move(drtv);
+    }
+  }
+
+  // Failure to create the stats, e.g. because of the plugin stat limit, is not fatal.
+  auto &&[samples, samples_errata]{ts::ShardedStat::make(samples_name)};
+  auto &&[cycles, cycles_errata]{ts::ShardedStat::make(cycles_name)};
+  if (!samples_errata.is_ok() || !cycles_errata.is_ok()) {
+    std::string text;
+    ts::Log_Warning(swoc::bwprint(text, "{}: {} at {} is not profiled - {}{}", Config::PLUGIN_TAG, name, mark, samples_errata, cycles_errata));
+    return std::move(drtv);
+  }
+
+  std::unique_ptr<self_type> self{new self_type(std::move(drtv), cfg.profile_sample())};
+  self->_samples = std::move(samples);
+  self->_cycles  = std::move(cycles);
+  return Handle(self.release());
+}
+
+Errata
+ProfileDirective::invoke(Context &ctx)
+{
+  if (!sample_p(_sample)) {
+    return _drtv->invoke(ctx);
+  }
+  auto t0   = cycle_count();
+  auto zret = _drtv->invoke(ctx);
+  auto t1   = cycle_count();
+  _samples->increment();
+  _cycles->increment(t1 - t0);
+  return zret;
+}
+/* ------------------------------------------------------------------------------------ */
 
 /* ------------------------------------------------------------------------------------ */
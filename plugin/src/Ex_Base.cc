@@ -413,6 +413,48 @@ Ex_env::format(BufferWriter &w, Spec const &spec, Context &)
   return bwformat(w, spec, spec._data.span.rebind<TextView>()[0]);
 }
 
+/* ------------------------------------------------------------------------------------ */
+/// Time spent invoking directives for a hook.
+class Ex_hook_time : public Extractor
+{
+  using self_type  = Ex_hook_time; ///< Self reference type.
+  using super_type = Extractor;    ///< Parent type.
+public:
+  static constexpr TextView NAME{"hook-time"};
+
+  Rv<ActiveType> validate(Config &cfg, Spec &spec, TextView const &arg) override;
+  Feature extract(Context &ctx, Spec const &spec) override;
+  BufferWriter &format(BufferWriter &w, Spec const &spec, Context &ctx) override;
+};
+
+Rv<ActiveType>
+Ex_hook_time::validate(Config &, Extractor::Spec &spec, TextView const &arg)
+{
+  Hook hook = Hook::INVALID; // total for all hooks.
+  if (!arg.empty()) {
+    hook = HookName[arg];
+    if (hook < Hook::TXN_START) {
+      return Errata(S_ERROR, R"("{}" extractor argument "{}" is not a transaction hook.)", NAME, arg);
+    }
+  }
+  spec._data.u = IndexFor(hook);
+  return ActiveType{NIL, DURATION};
+}
+
+Feature
+Ex_hook_time::extract(Context &ctx, Extractor::Spec const &spec)
+{
+  if (auto t = ctx.hook_time(static_cast<Hook>(spec._data.u)); t.count() >= 0) {
+    return t;
+  }
+  return NIL_FEATURE;
+}
+
+BufferWriter &
+Ex_hook_time::format(BufferWriter &w, Extractor::Spec const &spec, Context &ctx)
+{
+  return bwformat(w, spec, this->extract(ctx, spec));
+}
 /* ------------------------------------------------------------------------------------ */
 BufferWriter &
 Ex_this::format(BufferWriter &w, Extractor::Spec const &spec, Context &ctx)
@@ -447,6 +489,7 @@ Ex_txn_conf txn_conf;
 
 Ex_random random;
 Ex_env env;
+Ex_hook_time hook_time;
 
 static constexpr TextView NANOSECONDS = "nanoseconds";
 Ex_duration<std::chrono::nanoseconds, &NANOSECONDS> nanoseconds;
@@ -487,6 +530,7 @@ Ex_unmatched_group unmatched_group;
   Extractor::define(WEEKS, &weeks);
 
   Extractor::define(Ex_env::NAME, &env);
+  Extractor::define(Ex_hook_time::NAME, &hook_time);
 
   return true;
 }();
@@ -15,6 +15,7 @@
 #include "txn_box/Context.h"
 #include "txn_box/Directive.h"
 #include "txn_box/Comparison.h"
+#include "txn_box/StreamRewriter.h"
 
 #include "txn_box/yaml_util.h"
 #include "txn_box/ts_util.h"
@@ -2479,7 +2480,11 @@ Do_proxy_rsp_body::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   return handle;
 }
 /* ------------------------------------------------------------------------------------ */
-/// Replace the upstream response body with a feature.
+/** Replace the upstream response body with a feature.
+ *
+ * If the body is a literal or the content of a text block, it is shared via @c ts::SharedBody and
+ * not copied for each transaction.
+ */
 class Do_upstream_rsp_body : public Directive
 {
   using self_type  = Do_upstream_rsp_body; ///< Self reference type.
@@ -2488,6 +2493,8 @@ public:
   static const std::string KEY; ///< Directive name.
   static const HookMask HOOKS;  ///< Valid hooks for directive.
 
+  ~Do_upstream_rsp_body() noexcept;
+
   Errata invoke(Context &ctx) override; ///< Runtime activation.
 
   /** Load from YAML configuration.
@@ -2501,7 +2508,8 @@ public:
                          swoc::TextView const &arg, YAML::Node key_value);
 
 protected:
-  Expr _expr; ///< Body content.
+  Expr _expr;       ///< Body content.
+  TextView _shared; ///< Literal body published as a shared body.
 
   Do_upstream_rsp_body(Expr &&expr) : _expr(std::move(expr)) {}
 };
@@ -2509,6 +2517,13 @@ protected:
 const std::string Do_upstream_rsp_body::KEY{"upstream-rsp-body"};
 const HookMask Do_upstream_rsp_body::HOOKS{MaskFor({Hook::URSP})};
 
+Do_upstream_rsp_body::~Do_upstream_rsp_body() noexcept
+{
+  if (!_shared.empty()) {
+    ts::SharedBody::instance().withdraw(_shared);
+  }
+}
+
 Errata
 Do_upstream_rsp_body::invoke(Context &ctx)
 {
@@ -2557,11 +2572,14 @@ Do_upstream_rsp_body::invoke(Context &ctx)
           TSContCall(TSVIOContGet(in_vio),
                      (TSVIONTodoGet(in_vio) <= 0) ? TS_EVENT_VCONN_WRITE_COMPLETE : TS_EVENT_VCONN_WRITE_READY, in_vio);
         }
-        // If the buffer isn't already there, create it and write out the view.
+        // If the buffer isn't already there, create it and write out the view. Shared content is
+        // referenced rather than copied.
         if ( auto state = static_cast<State *>(TSContDataGet(contp)) ; state && ! state->_tsio_buff) {
           auto out_vconn = TSTransformOutputVConnGet(contp);
           state->_tsio_buff = TSIOBufferCreate();
-          TSIOBufferWrite(state->_tsio_buff, state->_view.data(), state->_view.size());
+          if (!ts::SharedBody::instance().append(state->_tsio_buff, state->_view)) {
+            TSIOBufferWrite(state->_tsio_buff, state->_view.data(), state->_view.size());
+          }
           auto out_vio = TSVConnWrite(out_vconn, contp, TSIOBufferReaderAlloc(state->_tsio_buff), state->_view.size());
           TSVIOReenable(out_vio);
         }
@@ -2617,7 +2635,281 @@ Do_upstream_rsp_body::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_n
     return Errata(S_ERROR, R"(The value for "{}" must be a string.)", KEY, drtv_node.Mark());
   }
 
-  return Handle(new self_type(std::move(expr)));
+  auto self = new self_type(std::move(expr));
+  Handle handle(self);
+  if (self->_expr.is_literal()) {
+    if (auto view = std::get_if<IndexFor(STRING)>(&std::get<Expr::LITERAL>(self->_expr._raw)); view) {
+      self->_shared = *view;
+      ts::SharedBody::instance().publish(self->_shared);
+    }
+  }
+  return handle;
+}
+/* ------------------------------------------------------------------------------------ */
+/** Rewrite the upstream response body as it streams.
+ *
+ * Literal and regular expression substitutions are applied chunk by chunk, the body is never
+ * buffered as a whole. @see StreamRewriter
+ */
+class Do_upstream_rsp_body_rewrite : public Directive
+{
+  using self_type  = Do_upstream_rsp_body_rewrite; ///< Self reference type.
+  using super_type = Directive;                    ///< Parent type.
+public:
+  static const std::string KEY;         ///< Directive name.
+  static const std::string RULES_KEY;   ///< Key for substitution rules.
+  static const std::string CARRY_KEY;   ///< Key for carry over limit.
+  static const std::string MATCH_KEY;   ///< Rule key for literal match.
+  static const std::string RXP_KEY;     ///< Rule key for regular expression match.
+  static const std::string REPLACE_KEY; ///< Rule key for replacement.
+  static const HookMask HOOKS;          ///< Valid hooks for directive.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML configuration.
+   *
+   * @param cfg Configuration data.
+   * @param drtv_node Node containing the directive.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  /// Substitution rule.
+  struct Rule {
+    TextView _match;      ///< Literal match.
+    std::optional<Rxp> _rxp; ///< Regular expression match.
+    Expr _replace;        ///< Replacement.
+  };
+
+  std::vector<Rule> _rules;                      ///< Substitutions.
+  size_t _carry = StreamRewriter::DEFAULT_CARRY; ///< Carry over limit.
+
+  /// Per transaction transform state.
+  struct State {
+    StreamRewriter _rw;                  ///< Substitution.
+    TSIOBuffer _out_buff       = nullptr; ///< Output buffer.
+    TSVIO _out_vio             = nullptr; ///< Output VIO.
+    int64_t _out_n             = 0;       ///< Bytes written to output.
+    bool _done_p               = false;   ///< Output is complete.
+
+    State(swoc::MemSpan<StreamRewriter::Rule const> rules, size_t carry) : _rw(rules, carry) {}
+    /// Clean up the @c IOBuffer - see @c Do_upstream_rsp_body for why this is done here.
+    ~State() {
+      if (_out_buff) {
+        TSIOBufferDestroy(_out_buff);
+      }
+    }
+  };
+
+  /// Transform continuation callback.
+  static int transform(TSCont contp, TSEvent ev_code, void *);
+
+  /// Load a rule from @a node.
+  Errata load_rule(Config &cfg, YAML::Node const &node);
+};
+
+const std::string Do_upstream_rsp_body_rewrite::KEY{"upstream-rsp-body-rewrite"};
+const std::string Do_upstream_rsp_body_rewrite::RULES_KEY{"rules"};
+const std::string Do_upstream_rsp_body_rewrite::CARRY_KEY{"carry"};
+const std::string Do_upstream_rsp_body_rewrite::MATCH_KEY{"match"};
+const std::string Do_upstream_rsp_body_rewrite::RXP_KEY{"rxp"};
+const std::string Do_upstream_rsp_body_rewrite::REPLACE_KEY{"replace"};
+const HookMask Do_upstream_rsp_body_rewrite::HOOKS{MaskFor({Hook::URSP})};
+
+int
+Do_upstream_rsp_body_rewrite::transform(TSCont contp, TSEvent ev_code, void *)
+{
+  if (TSVConnClosedGet(contp)) {
+    // IOBuffer is cleaned up at transaction close, not here.
+    TSContDestroy(contp);
+    return 0;
+  }
+
+  auto in_vio = TSVConnWriteVIOGet(contp);
+  switch (ev_code) {
+  case TS_EVENT_ERROR:
+    TSContCall(TSVIOContGet(in_vio), TS_EVENT_ERROR, in_vio);
+    break;
+  case TS_EVENT_VCONN_WRITE_COMPLETE:
+    TSVConnShutdown(TSTransformOutputVConnGet(contp), 0, 1);
+    break;
+  default: {
+    auto state = static_cast<State *>(TSContDataGet(contp));
+    if (nullptr == state || state->_done_p) {
+      break;
+    }
+    auto out = [=](TextView text) {
+      if (text) {
+        TSIOBufferWrite(state->_out_buff, text.data(), text.size());
+        state->_out_n += text.size();
+      }
+    };
+    if (!state->_out_buff) {
+      state->_out_buff = TSIOBufferCreate();
+      state->_out_vio  = TSVConnWrite(TSTransformOutputVConnGet(contp), contp, TSIOBufferReaderAlloc(state->_out_buff), INT64_MAX);
+    }
+
+    // If there is no input buffer the upstream is done, otherwise process what is available.
+    if (TSVIOBufferGet(in_vio)) {
+      auto todo = TSVIONTodoGet(in_vio);
+      if (todo > 0) {
+        auto reader = TSVIOReaderGet(in_vio);
+        auto avail  = std::min(todo, TSIOBufferReaderAvail(reader));
+        if (avail > 0) {
+          auto n_left = avail;
+          for (auto block = TSIOBufferReaderStart(reader); block && n_left > 0; block = TSIOBufferBlockNext(block)) {
+            int64_t n = 0;
+            auto data = TSIOBufferBlockReadStart(block, reader, &n);
+            n         = std::min(n, n_left);
+            state->_rw.write(TextView{data, size_t(n)}, false, out);
+            n_left -= n;
+          }
+          TSIOBufferReaderConsume(reader, avail);
+          TSVIONDoneSet(in_vio, TSVIONDoneGet(in_vio) + avail);
+        }
+        if (TSVIONTodoGet(in_vio) > 0) {
+          if (avail > 0) {
+            TSVIOReenable(state->_out_vio);
+            TSContCall(TSVIOContGet(in_vio), TS_EVENT_VCONN_WRITE_READY, in_vio);
+          }
+          break;
+        }
+      }
+    }
+
+    // All input has been processed.
+    state->_rw.write(TextView{}, true, out);
+    state->_done_p = true;
+    TSVIONBytesSet(state->_out_vio, state->_out_n);
+    TSVIOReenable(state->_out_vio);
+    if (TSVIOBufferGet(in_vio)) {
+      TSContCall(TSVIOContGet(in_vio), TS_EVENT_VCONN_WRITE_COMPLETE, in_vio);
+    }
+  } break;
+  }
+
+  return 0;
+}
+
+Errata
+Do_upstream_rsp_body_rewrite::invoke(Context &ctx)
+{
+  // Replacements are extracted once per transaction, the transform uses them for the entire body.
+  auto rules = ctx.alloc_span<StreamRewriter::Rule>(_rules.size());
+  for (unsigned idx = 0; idx < _rules.size(); ++idx) {
+    auto &rule  = _rules[idx];
+    auto value  = ctx.extract(rule._replace);
+    auto &&text = std::get_if<IndexFor(STRING)>(&ctx.commit(value));
+    if (nullptr == text) {
+      return Errata(S_ERROR, R"(Value for "{}" in "{}" is not a string.)", REPLACE_KEY, KEY);
+    }
+    rules[idx] = StreamRewriter::Rule{rule._match, rule._rxp ? rule._rxp->code() : nullptr, *text};
+  }
+
+  auto state = ctx.make<State>(swoc::MemSpan<StreamRewriter::Rule const>{rules.data(), rules.count()}, _carry);
+  ctx.mark_for_cleanup(state);
+  auto cont = TSTransformCreate(&self_type::transform, ctx._txn);
+  TSContDataSet(cont, state);
+  TSHttpTxnHookAdd(ctx._txn, TS_HTTP_RESPONSE_TRANSFORM_HOOK, cont);
+  return {};
+}
+
+Errata
+Do_upstream_rsp_body_rewrite::load_rule(Config &cfg, YAML::Node const &node)
+{
+  if (!node.IsMap()) {
+    return Errata(S_ERROR, R"(Rule at {} for "{}" is not a map.)", node.Mark(), KEY);
+  }
+  auto match_node = node[MATCH_KEY];
+  auto rxp_node   = node[RXP_KEY];
+  if (bool(match_node) == bool(rxp_node)) {
+    return Errata(S_ERROR, R"(Rule at {} for "{}" must have exactly one of "{}" or "{}".)", node.Mark(), KEY, MATCH_KEY, RXP_KEY);
+  }
+
+  auto &&[expr, errata]{cfg.parse_expr(match_node ? match_node : rxp_node)};
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+  if (!expr.is_literal() || !expr.result_type().can_satisfy(STRING)) {
+    return Errata(S_ERROR, R"(Match for rule at {} for "{}" must be a literal string.)", node.Mark(), KEY);
+  }
+  auto text = std::get<IndexFor(STRING)>(std::get<Expr::LITERAL>(expr._raw));
+  if (text.empty()) {
+    return Errata(S_ERROR, R"(Match for rule at {} for "{}" must not be empty.)", node.Mark(), KEY);
+  }
+
+  Rule rule;
+  if (match_node) {
+    rule._match = text;
+  } else {
+    auto &&[rxp, rxp_errata]{Rxp::parse(text, Rxp::Options{0})};
+    if (!rxp_errata.is_ok()) {
+      rxp_errata.note(R"(While parsing rule at {} for "{}".)", node.Mark(), KEY);
+      return std::move(rxp_errata);
+    }
+    rule._rxp.emplace(std::move(rxp));
+  }
+
+  if (auto replace_node = node[REPLACE_KEY]; replace_node) {
+    auto &&[replace, replace_errata]{cfg.parse_expr(replace_node)};
+    if (!replace_errata.is_ok()) {
+      return std::move(replace_errata);
+    }
+    if (!replace.result_type().can_satisfy(STRING)) {
+      return Errata(S_ERROR, R"(Value for "{}" in rule at {} for "{}" must be a string.)", REPLACE_KEY, node.Mark(), KEY);
+    }
+    rule._replace = std::move(replace);
+  } else {
+    rule._replace = Expr{FeatureView::Literal("")}; // remove the match.
+  }
+
+  _rules.emplace_back(std::move(rule));
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_upstream_rsp_body_rewrite::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &,
+                                   swoc::TextView const &, YAML::Node key_value)
+{
+  auto self = new self_type;
+  Handle handle(self);
+
+  // Don't assign to an existing node, that overwrites the node in the YAML tree.
+  YAML::Node rules_node = key_value.IsMap() ? key_value[RULES_KEY] : key_value;
+  if (key_value.IsMap()) {
+    if (auto carry_node = key_value[CARRY_KEY]; carry_node) {
+      auto &&[carry_expr, carry_errata]{cfg.parse_expr(carry_node)};
+      if (!carry_errata.is_ok()) {
+        carry_errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+        return std::move(carry_errata);
+      }
+      feature_type_for<INTEGER> carry = -1;
+      if (carry_expr.is_literal()) {
+        carry = std::get<Expr::LITERAL>(carry_expr._raw).as_integer(-1);
+      }
+      if (carry < 0) {
+        return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be a literal non-negative integer.)", CARRY_KEY,
+                      carry_node.Mark(), KEY, drtv_node.Mark());
+      }
+      self->_carry = carry;
+    }
+  }
+  if (!rules_node || !rules_node.IsSequence()) {
+    return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a list of rules or a map with a "{}" key.)", KEY,
+                  drtv_node.Mark(), RULES_KEY);
+  }
+
+  for (auto const &rule_node : rules_node) {
+    if (auto errata = self->load_rule(cfg, rule_node); !errata.is_ok()) {
+      errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+      return std::move(errata);
+    }
+  }
+
+  return handle;
 }
 // ---
 /// Immediate proxy reply.
@@ -3574,6 +3866,7 @@ protected:
   struct Case {
     Comparison::Handle _cmp; ///< Comparison to perform.
     Directive::Handle _do;   ///< Directives to execute.
+    std::unique_ptr<ts::ShardedStat> _stat; ///< Match counter, if any.
   };
   using CaseGroup = std::vector<Case>;
   CaseGroup _cases; ///< List of cases for the select.
@@ -3624,6 +3917,9 @@ Do_with::invoke(Context &ctx)
   ctx.mark_terminal(false); // default is continue on.
   for (auto const &c : _cases) {
     if (!c._cmp || (*c._cmp)(ctx, feature)) {
+      if (c._stat) {
+        c._stat->increment();
+      }
       if (c._do) {
         c._do->invoke(ctx);
       }
@@ -3711,9 +4007,14 @@ Do_with::load_case(Config &cfg, YAML::Node node)
   if (node.IsMap()) {
     Case c;
     YAML::Node do_node{node[DO_KEY]};
-    // It's allowed to have no comparison, which is either an empty map or only a DO key.
-    // In that case the comparison always matches.
-    if (node.size() > 1 || (node.size() == 1 && !do_node)) {
+    auto &&[stat, stat_errata]{ComparisonGroupBase::load_stat(cfg, node)};
+    if (!stat_errata.is_ok()) {
+      return std::move(stat_errata);
+    }
+    c._stat = std::move(stat);
+    // It's allowed to have no comparison, which is either an empty map or only a DO key and
+    // STAT key. In that case the comparison always matches.
+    if (node.size() > (do_node ? 1 : 0) + (c._stat ? 1 : 0)) {
       auto f_scope = cfg.feature_scope(_expr.result_type());
       auto &&[cmp_handle, cmp_errata]{Comparison::load(cfg, node)};
       if (cmp_errata.is_ok()) {
@@ -3829,6 +4130,7 @@ namespace
   Config::define<Do_proxy_rsp_body>();
 
   Config::define<Do_upstream_rsp_body>();
+  Config::define<Do_upstream_rsp_body_rewrite>();
 
   Config::define<Do_cache_key>();
   Config::define<Do_txn_conf>();
@@ -9,6 +9,7 @@
 #include "txn_box/Config.h"
 #include "txn_box/Comparison.h"
 #include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
 
 using swoc::TextView;
 using swoc::Errata;
@@ -349,6 +350,7 @@ public:
     Action _action = PASS;   ///< Action on match.
     Expr _expr;              ///< Replacement expression, if any.
     Comparison::Handle _cmp; ///< Comparison.
+    std::unique_ptr<ts::ShardedStat> _stat; ///< Match counter, if any.
 
     /// Assign the comparison for this case.
     void assign(Comparison::Handle &&handle);
@@ -359,13 +361,13 @@ public:
      *
      * @param cfg Configuration.
      * @param node Node containing comparison.
-     * @return Errors, if any.
+     * @return The number of keys in @a node handled by the case, or errors.
      *
      * This is called during case loading, before the generic loading is done. It is required to
-     * check any non-generic keys and remove them - anything not expected by the generic load will
-     * be flagged as an error.
+     * check any non-generic keys and report how many there are. These keys are not removed so that
+     * @a node is not modified - it may be a cached tree that is loaded again.
      */
-    Errata pre_load(Config &cfg, YAML::Node node);
+    Rv<unsigned> pre_load(Config &cfg, YAML::Node node);
   };
 
   /// Container for cases with comparisons.
@@ -397,6 +399,9 @@ Mod_filter::compare(Context &ctx, Feature const &feature) const -> Case const *
 {
   for (auto const &c : _cases) {
     if (!c._cmp || (*c._cmp)(ctx, feature)) {
+      if (c._stat) {
+        c._stat->increment();
+      }
       return &c;
     }
   }
@@ -415,6 +420,9 @@ Mod_filter::operator()(Context &ctx, Feature &feature)
     for (Feature f = feature; !is_nil(f); f = cdr(f)) {
       Feature item  = car(f);
       auto c        = _cases(ctx, item);
+      if (c != _cases.end() && c->_stat) {
+        c->_stat->increment();
+      }
       Action action = ((c != _cases.end()) ? c->_action : DROP);
       switch (action) {
       case DROP:
@@ -456,7 +464,7 @@ Mod_filter::Case::assign(Comparison::Handle &&handle)
   _cmp = std::move(handle);
 }
 
-Errata
+Rv<unsigned>
 Mod_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node)
 {
   if (!cmp_node.IsMap()) {
@@ -473,14 +481,12 @@ Mod_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node)
   YAML::Node drop_node = cmp_node[ACTION_DROP];
   if (drop_node) {
     _action = DROP;
-    cmp_node.remove(ACTION_DROP);
     ++action_count;
   }
 
   YAML::Node pass_node = cmp_node[ACTION_PASS];
   if (pass_node) {
     _action = PASS;
-    cmp_node.remove(ACTION_PASS);
     ++action_count;
   }
 
@@ -494,7 +500,6 @@ Mod_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node)
     }
     _expr   = std::move(expr);
     _action = REPLACE;
-    cmp_node.remove(ACTION_REPLACE);
     ++action_count;
   }
 
@@ -503,7 +508,13 @@ Mod_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node)
                  cmp_node.Mark());
   }
 
-  return {};
+  auto &&[stat, stat_errata]{ComparisonGroupBase::load_stat(cfg, cmp_node)};
+  if (!stat_errata.is_ok()) {
+    return std::move(stat_errata);
+  }
+  _stat = std::move(stat);
+
+  return action_count + (_stat ? 1 : 0);
 }
 
 bool
@@ -5,8 +5,17 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
-#include <shared_mutex>
+#include <algorithm>
+#include <array>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "txn_box/common.h"
 
@@ -26,6 +35,7 @@
 
 #include "txn_box/yaml_util.h"
 #include "txn_box/ts_util.h"
+#include "txn_box/Epoch.h"
 
 using swoc::TextView;
 using swoc::Errata;
@@ -58,20 +68,227 @@ enum class ColumnData {
 using Row = MemSpan<std::byte>;
 /// IPSpace to store the rows.
 using Space = IPSpace<Row>;
+
+/** Binary (precompiled) IP space file layout.
+ *
+ * The file is memory mapped and used in place. It consists of
+ * - The header.
+ * - The column types, one byte per column, padded to @c ALIGN.
+ * - The IPv4 ranges, sorted.
+ * - The IPv6 ranges, sorted.
+ * - The rows, one for each range, IPv4 ranges first. The layout is the same as for the CSV rows
+ *   except that @c STRING and @c ENUM cells contain a @c StrRef instead of a @c TextView or tag.
+ * - The string table.
+ *
+ * All values are in host order except IPv6 addresses which are in network order so they can be
+ * compared with @c memcmp. The file is therefore not portable across architectures.
+ */
+namespace binary
+{
+static constexpr TextView MAGIC{"TXNBOXIP"}; ///< File identifier.
+static constexpr uint32_t VERSION = 1;       ///< Current format version.
+static constexpr size_t ALIGN     = 8;       ///< Alignment of the file sections.
+
+/// File header.
+struct Header {
+  char _magic[8];         ///< @c MAGIC
+  uint32_t _version;      ///< Format version.
+  uint32_t _row_size;     ///< Size of a row in bytes.
+  uint32_t _n_cols;       ///< Number of columns, including the range column.
+  uint32_t _reserved;     ///< Padding.
+  uint64_t _n_ip4;        ///< Number of IPv4 ranges.
+  uint64_t _n_ip6;        ///< Number of IPv6 ranges.
+  uint64_t _strings_size; ///< Size of the string table.
+};
+
+/// IPv4 range, host order.
+struct Range4 {
+  uint32_t _min;
+  uint32_t _max;
+};
+
+/// IPv6 range, network order.
+struct Range6 {
+  uint8_t _min[16];
+  uint8_t _max[16];
+};
+
+/// String cell - location in the string table.
+struct StrRef {
+  uint32_t _offset;
+  uint32_t _size;
+};
+
+/// Round @a n up to @c ALIGN.
+inline size_t
+aligned(size_t n)
+{
+  return (n + ALIGN - 1) & ~(ALIGN - 1);
+}
+} // namespace binary
+
 /// Space information that must be reloaded on file change.
-struct SpaceInfo {
-  Space space;          ///< IPSpace.
-  swoc::MemArena arena; ///< Row storage.
+struct SpaceInfo : public std::enable_shared_from_this<SpaceInfo> {
+  Space space;                      ///< IPSpace.
+  /// Row and string storage, one per parsed chunk. These are shared with spaces created by
+  /// applying a delta to this space.
+  std::vector<std::shared_ptr<swoc::MemArena>> arenas;
+
+  /// Memory mapped binary file, if loaded from one. If so @a space is not used.
+  MemSpan<std::byte> image;
+  MemSpan<binary::Range4 const> ip4;   ///< IPv4 ranges in @a image.
+  MemSpan<binary::Range6 const> ip6;   ///< IPv6 ranges in @a image.
+  std::byte *rows = nullptr;           ///< Rows in @a image.
+  size_t row_size = 0;                 ///< Size of a row.
+  TextView strings;                    ///< String table in @a image.
+
+  /// Unique identifier for this instance, used to validate cached lookups.
+  uint64_t generation = ++Generation;
+  /// Number of deltas applied since the space was loaded or compacted.
+  unsigned delta_count = 0;
+
+  SpaceInfo() = default;
+  SpaceInfo(SpaceInfo const &) = delete;
+  ~SpaceInfo();
+
+  /// Search positions for a sequence of lookups in increasing address order.
+  struct Hint {
+    size_t _ip4 = 0; ///< Lower bound for the next IPv4 search.
+    size_t _ip6 = 0; ///< Lower bound for the next IPv6 search.
+  };
+
+  /** Find the row for an address.
+   *
+   * @param addr Search address.
+   * @param hint Search positions, updated for the next search.
+   * @return The row for @a addr, or an empty row if not found.
+   *
+   * If @a hint is shared across lookups, they must be done in increasing address order. The
+   * remaining search range then shrinks with each lookup.
+   */
+  Row find(IPAddr const &addr, Hint &hint);
+
+  /// Find the row for an address.
+  Row
+  find(IPAddr const &addr)
+  {
+    Hint hint;
+    return this->find(addr, hint);
+  }
+
+  /** Get the text for a string cell.
+   *
+   * @param data Cell data.
+   * @return The text.
+   *
+   * This must be used only if @a image is not empty, for the CSV rows the cell contains the text.
+   */
+  TextView
+  text(MemSpan<std::byte> data) const
+  {
+    auto ref = data.rebind<binary::StrRef>()[0];
+    return strings.substr(ref._offset, ref._size);
+  }
+
+  /// Source of @a generation values. Zero is never used.
+  static inline std::atomic<uint64_t> Generation{0};
 };
 
+SpaceInfo::~SpaceInfo()
+{
+  if (image.data()) {
+    munmap(image.data(), image.size());
+  }
+}
+
+Row
+SpaceInfo::find(IPAddr const &addr, Hint &hint)
+{
+  if (!image.data()) {
+    if (auto spot = space.find(addr); spot != space.end()) {
+      return std::get<1>(*spot);
+    }
+    return {};
+  }
+
+  // Binary - find the last range with a minimum that is not larger than @a addr.
+  // The mapped rows are never changed by the caller, therefore the mapping is read only.
+  if (addr.is_ip4()) {
+    auto key  = addr.ip4().host_order();
+    auto spot = std::upper_bound(ip4.begin() + hint._ip4, ip4.end(), key, [](uint32_t k, binary::Range4 const &r) { return k < r._min; });
+    hint._ip4 = std::max<size_t>(spot - ip4.begin(), 1) - 1; // next key may be in the same range.
+    if (spot != ip4.begin() && key <= (--spot)->_max) {
+      return {rows + (spot - ip4.begin()) * row_size, row_size};
+    }
+  } else if (addr.is_ip6()) {
+    auto key  = addr.ip6().network_order();
+    auto spot = std::upper_bound(ip6.begin() + hint._ip6, ip6.end(), key,
+                                 [](in6_addr const &k, binary::Range6 const &r) { return memcmp(&k, r._min, sizeof(r._min)) < 0; });
+    hint._ip6 = std::max<size_t>(spot - ip6.begin(), 1) - 1; // next key may be in the same range.
+    if (spot != ip6.begin() && memcmp(&key, (--spot)->_max, sizeof(key)) <= 0) {
+      return {rows + (ip4.count() + (spot - ip6.begin())) * row_size, row_size};
+    }
+  }
+  return {};
+}
+
 using SpaceHandle = std::shared_ptr<SpaceInfo>;
+
+/// A space used by a transaction, which keeps the space until the transaction is done.
+struct HeldSpace {
+  Do_ip_space_define const *_drtv = nullptr; ///< Directive for the space.
+  SpaceHandle _space;                        ///< The space.
+  HeldSpace *_next = nullptr;                ///< Next space held by the transaction.
+};
+
+/** Per thread cache of recent lookups.
+ *
+ * This is direct mapped. Entries are keyed by the address and the space generation, therefore a
+ * reload invalidates the entries for the previous space without any coordination. An entry for
+ * a destroyed space can never match because generations are not reused.
+ */
+struct HotCache {
+  static constexpr unsigned N_BITS   = 9;           ///< Bits in an entry index.
+  static constexpr size_t N_ENTRIES = 1 << N_BITS; ///< Number of entries.
+
+  struct Entry {
+    uint64_t _generation = 0; ///< Generation of the space, zero if not valid.
+    IPAddr _addr;             ///< Search address.
+    Row _row;                 ///< Lookup result.
+  };
+  std::array<Entry, N_ENTRIES> _entries;
+
+  /** Get the entry slot for a lookup.
+   *
+   * @param space Space to search.
+   * @param addr Search address.
+   * @return The entry slot, which matches only if the entry is for @a space and @a addr.
+   */
+  Entry &
+  slot(SpaceInfo const &space, IPAddr const &addr)
+  {
+    uint64_t key = space.generation;
+    if (addr.is_ip4()) {
+      key ^= addr.ip4().host_order();
+    } else if (addr.is_ip6()) {
+      auto a6 = addr.ip6().network_order();
+      uint64_t w[2];
+      memcpy(w, &a6, sizeof(w));
+      key ^= w[0] ^ w[1];
+    }
+    key *= 0x9E3779B97F4A7C15ULL; // Fibonacci hashing, use the high bits.
+    return _entries[key >> (64 - N_BITS)];
+  }
+};
+
+thread_local HotCache Hot_Cache;
 /// Context information for the active IP Space.
 /// This is set up by the @c ip-space modifier and is only valid in the expression scope.
 struct CtxActiveInfo {
-  SpaceHandle _space;                  ///< Active space.
+  SpaceInfo *_space = nullptr;         ///< Active space.
   Do_ip_space_define * _drtv = nullptr; ///< Active directive.
   IPAddr _addr;                        ///< Search address.
-  Row *_row = nullptr;                 ///< Active row.
+  Row _row;                            ///< Active row, empty if not found.
 };
 
 } // namespace
@@ -217,7 +434,9 @@ struct Txb_IP_Space {
   /// An instance of this is stored in the configuration arena.
   struct CfgInfo {
     ReservedSpan _ctx_reserved_span; ///< Per context reserved storage.
+    ReservedSpan _ctx_held_span;     ///< Per context reserved storage, for spaces in use.
     Map _map; ///< Map of defined spaces.
+    Epoch _epoch; ///< Reclamation of reloaded spaces.
   };
 
   /** Retrieve configuration level information.
@@ -255,6 +474,7 @@ public:
   struct Updater {
     std::weak_ptr<Config> _cfg; ///< Configuration.
     Do_ip_space_define *_block; ///< Space instance.
+    bool _watch_p = false;      ///< Invoked by the file watch - check immediately.
 
     void operator()(); ///< Do the update check.
   };
@@ -307,9 +527,9 @@ protected:
      * @return Data for @a this column in that @a row.
      */
     MemSpan<std::byte>
-    data_in_row(Row *row)
+    data_in_row(Row const &row)
     {
-      return {row->data() + _row_offset, _row_size};
+      return {row.data() + _row_offset, _row_size};
     }
 
     /// Mapping between strings and @c ColumnData enumeration values.
@@ -318,8 +538,9 @@ protected:
 
   TextView _name;                 ///< Block name.
   swoc::file::path _path;         ///< Path to file (optional)
-  SpaceHandle _space;             ///< The IP Space
-  std::shared_mutex _space_mutex; ///< Reader / writer for @a _space.
+  swoc::file::path _delta_path;   ///< Path to delta file (optional)
+  std::atomic<SpaceInfo *> _space{nullptr}; ///< The IP Space, for readers.
+  SpaceHandle _space_handle;                ///< The IP Space, owning.
 
   std::vector<Column> _cols;             ///< Defined columns.
   swoc::Lexicon<unsigned> _col_names;    ///< Mapping of names <-> indices.
@@ -331,10 +552,18 @@ protected:
   std::atomic<std::chrono::system_clock::duration> _last_check =
     std::chrono::system_clock::now().time_since_epoch(); ///< Absolute time of the last alert.
   std::chrono::system_clock::time_point _last_modified;  ///< Last modified time of the file.
+  std::chrono::system_clock::time_point _delta_modified; ///< Last modified time of the applied delta file.
   ts::TaskHandle _task;                                  ///< Handle for periodic checking task.
+  unsigned _watch_id       = 0;                          ///< File watch identifier, 0 if none.
+  unsigned _delta_watch_id = 0;                          ///< Delta file watch identifier, 0 if none.
+  std::mutex _update_mutex;                              ///< Serialize updates.
 
   int _line_no = 0; ///< For debugging name conflicts.
 
+  bool _cache_p  = false; ///< Use the per thread lookup cache.
+  std::unique_ptr<ts::ShardedStat> _hit_stat;  ///< Cache hits, if caching.
+  std::unique_ptr<ts::ShardedStat> _miss_stat; ///< Cache misses, if caching.
+
   /// YAML key names.
   ///@{
   static const std::string NAME_TAG;
@@ -343,12 +572,43 @@ protected:
   static const std::string DURATION_TAG;
   static const std::string TYPE_TAG;
   static const std::string VALUES_TAG;
+  static const std::string CACHE_TAG;
+  static const std::string DELTA_TAG;
   ///@}
 
   Do_ip_space_define() = default; ///< Default constructor.
 
-  SpaceHandle
-  acquire_space();
+  /** Get the current space.
+   *
+   * @param ctx Transaction context.
+   * @return The current space.
+   *
+   * This does not lock. The first call for a transaction takes a reference to the current space,
+   * which is used for the rest of the transaction. The space and any strings in it remain valid
+   * until @a ctx is destroyed, even if the space is replaced. Only that space is kept, not the
+   * spaces published while the transaction is running.
+   */
+  SpaceInfo *acquire_space(Context &ctx);
+
+  /** Publish a space.
+   *
+   * @param epoch Epoch for retiring the current space.
+   * @param space The new space.
+   *
+   * @a _update_mutex must be held, except during configuration load.
+   */
+  void publish(Epoch &epoch, SpaceHandle space);
+
+  /** Find the row for an address.
+   *
+   * @param space Space to search.
+   * @param addr Search address.
+   * @param hint Search positions, see @c SpaceInfo::find.
+   * @return The row for @a addr, or an empty row if not found.
+   *
+   * If enabled, the per thread lookup cache is used.
+   */
+  Row find(SpaceInfo &space, IPAddr const &addr, SpaceInfo::Hint &hint);
 
   /// Get the map of IP Space directives from the @a cfg.
   //  static Map* map(Config& cfg);
@@ -361,26 +621,165 @@ protected:
    */
   Errata define_column(Config &cfg, YAML::Node node);
 
+  /// Minimum size of content to parse on a separate thread.
+  static constexpr size_t CHUNK_MIN_SIZE = 1 << 20;
+
+  /// Data for parsing a chunk of the input file.
+  struct Chunk {
+    /// Column and name of a tag.
+    using TagKey = std::pair<unsigned, std::string_view>;
+
+    TextView _content;                                       ///< Text to parse, always complete lines.
+    unsigned _line_count = 0;                                ///< Line number of the last line parsed.
+    std::vector<std::pair<IPRange, Row>> _rows;              ///< Parsed rows, in file order.
+    swoc::MemArena *_arena = nullptr;                        ///< Row and string storage.
+    std::unordered_map<std::string_view, TextView> _strings; ///< Strings in @a _arena.
+    /// Tags to be auto defined, in order of first use in the chunk.
+    std::vector<TagKey> _new_tags;
+    std::map<TagKey, unsigned> _new_tag_idx; ///< Index in @a _new_tags of a tag.
+    /// Cells with a tag to be defined, and the index of the tag in @a _new_tags.
+    std::vector<std::pair<feature_type_for<INTEGER> *, unsigned>> _tag_cells;
+
+    /** Localize @a text in the chunk arena.
+     *
+     * @param text Text to localize.
+     * @return A view of the local copy.
+     *
+     * Identical strings are stored only once.
+     */
+    TextView localize(TextView const &text);
+  };
+
   /** Parse the input file.
    *
-   * @param cfg Configuration instance.
    * @param content File content.
    * @return The parsed space, or errors.
+   *
+   * All data for the space, including strings, is stored in the returned space and is released
+   * with it. Large content is split in to chunks which are parsed in parallel.
+   */
+  Rv<SpaceHandle> parse_space(TextView content);
+
+  /** Parse a chunk of the input file.
+   *
+   * @param chunk Chunk to parse.
+   * @param line_offset Number of lines in the file before @a chunk.
+   * @return Errors, if any.
+   *
+   * The rows are stored in @a chunk to be added to the space in file order. Line numbers in errors
+   * are for the file, not the chunk.
    */
-  Rv<SpaceHandle> parse_space(Config &cfg, TextView content);
+  Errata parse_chunk(Chunk &chunk, unsigned line_offset = 0);
+
+  /** Parse a row.
+   *
+   * @param chunk Chunk containing the row.
+   * @param line Text of the row.
+   * @return Errors, if any.
+   *
+   * The row is added to the rows in @a chunk.
+   */
+  Errata parse_line(Chunk &chunk, TextView line);
+
+  /** Define the tags first used in a chunk.
+   *
+   * @param chunk Parsed chunk.
+   *
+   * Tags are not defined while parsing so that chunks can be parsed in parallel without locking
+   * the tags. The tags are defined in file order by calling this for each chunk in order, so tag
+   * values do not depend on thread scheduling. The cells that use the tags are updated.
+   */
+  void define_tags(Chunk &chunk);
+
+  /** Apply a delta to a space.
+   *
+   * @param base Space to update.
+   * @param content Delta file content.
+   * @return A new space with the changes, or errors.
+   *
+   * @a base is not changed. The new space shares row storage with @a base.
+   */
+  Rv<SpaceHandle> apply_delta(SpaceInfo const &base, TextView content);
+
+  /// Number of deltas applied before the row storage is compacted.
+  static constexpr unsigned MAX_DELTAS = 16;
+
+  /** Copy a space in to new storage.
+   *
+   * @param src Space to copy.
+   * @return A space with the same content as @a src with all rows in a single arena.
+   *
+   * Only rows in use are copied, so storage for rows replaced or removed by deltas is released
+   * when @a src is no longer in use.
+   */
+  SpaceHandle compact(SpaceInfo const &src);
+
+  /** Apply the delta file if it has changed.
+   *
+   * @param base Current space.
+   * @return The updated space, @c nullptr if there is no change, or errors.
+   *
+   * The delta file is applied only if it is newer than the full file and was not already applied.
+   */
+  Rv<SpaceHandle> update_delta(SpaceInfo const &base);
+
+  /** Load the space from the file.
+   *
+   * @return The loaded space, or errors.
+   *
+   * If the file is in the binary format it is mapped, otherwise it is parsed as CSV.
+   */
+  Rv<SpaceHandle> load_space();
+
+  /** Map a binary space file.
+   *
+   * @param fd Open file descriptor for the file.
+   * @return The mapped space, or errors.
+   *
+   * The file must match the column definitions of this directive.
+   */
+  Rv<SpaceHandle> map_space(int fd);
+
+  /** Write the current space in the binary format.
+   *
+   * @param path Output file.
+   * @return Errors, if any.
+   */
+  Errata write_binary(swoc::file::path const &path);
 
   /// Check if it is time to do a modified check on the file content.
   bool should_check();
 
+  friend Errata IP_Space_Write_Binary(Config &cfg, swoc::file::path const &dir);
+
   friend class Mod_ip_space;
   friend class Ex_ip_col;
+  friend class Ex_ip_col_flags;
   friend Updater;
 };
 
+TextView
+Do_ip_space_define::Chunk::localize(TextView const &text)
+{
+  if (text.empty()) {
+    return {};
+  }
+  if (auto spot = _strings.find(text); spot != _strings.end()) {
+    return spot->second;
+  }
+  auto span = _arena->alloc(text.size()).rebind<char>();
+  memcpy(span, text);
+  TextView zret{span.data(), span.size()};
+  _strings.emplace(zret, zret);
+  return zret;
+}
+
 const std::string Do_ip_space_define::NAME_TAG{"name"};
 const std::string Do_ip_space_define::PATH_TAG{"path"};
 const std::string Do_ip_space_define::COLUMNS_TAG{"columns"};
 const std::string Do_ip_space_define::DURATION_TAG{"duration"};
+const std::string Do_ip_space_define::CACHE_TAG{"cache"};
+const std::string Do_ip_space_define::DELTA_TAG{"delta"};
 const std::string Do_ip_space_define::TYPE_TAG{"type"};
 const std::string Do_ip_space_define::VALUES_TAG{"values"};
 
@@ -392,6 +791,12 @@ const swoc::Lexicon<ColumnData> Do_ip_space_define::Column::TypeNames{
 
 Do_ip_space_define::~Do_ip_space_define() noexcept
 {
+  if (_watch_id) {
+    ts::FileWatch::instance().unwatch(_watch_id);
+  }
+  if (_delta_watch_id) {
+    ts::FileWatch::instance().unwatch(_delta_watch_id);
+  }
   _task.cancel();
 }
 
@@ -416,82 +821,246 @@ Do_ip_space_define::should_check()
 Errata
 Do_ip_space_define::invoke(Context &ctx)
 {
-  // Start update checking.
+  // Start update checking. Changes are detected by the file watch, the periodic check is a
+  // fallback in case a change is missed.
   if (_duration.count()) {
     _task =
       ts::PerformAsTaskEvery(Updater{ctx.acquire_cfg(), this}, std::chrono::duration_cast<std::chrono::milliseconds>(_duration));
+    _watch_id = ts::FileWatch::instance().watch(_path, Updater{ctx.acquire_cfg(), this, true});
+    if (!_delta_path.empty()) {
+      _delta_watch_id = ts::FileWatch::instance().watch(_delta_path, Updater{ctx.acquire_cfg(), this, true});
+    }
+  }
+  if (_cache_p) {
+    std::string name;
+    // Counted on every lookup, therefore sharded to avoid contention.
+    auto &&[hit_stat, hit_errata]{ts::ShardedStat::make(swoc::bwprint(name, "plugin.{}.ip-space.{}.cache-hit", Config::PLUGIN_TAG, _name))};
+    if (!hit_errata.is_ok()) {
+      return std::move(hit_errata);
+    }
+    auto &&[miss_stat, miss_errata]{
+      ts::ShardedStat::make(swoc::bwprint(name, "plugin.{}.ip-space.{}.cache-miss", Config::PLUGIN_TAG, _name))};
+    if (!miss_errata.is_ok()) {
+      return std::move(miss_errata);
+    }
+    _hit_stat  = std::move(hit_stat);
+    _miss_stat = std::move(miss_stat);
   }
   return {};
 }
 
+Row
+Do_ip_space_define::find(SpaceInfo &space, IPAddr const &addr, SpaceInfo::Hint &hint)
+{
+  if (!_cache_p) {
+    return space.find(addr, hint);
+  }
+  auto &entry = Hot_Cache.slot(space, addr);
+  if (entry._generation == space.generation && entry._addr == addr) {
+    if (_hit_stat) {
+      _hit_stat->increment();
+    }
+    return entry._row;
+  }
+  if (_miss_stat) {
+    _miss_stat->increment();
+  }
+  entry._generation = space.generation;
+  entry._addr       = addr;
+  entry._row        = space.find(addr, hint);
+  return entry._row;
+}
+
 auto
-Do_ip_space_define::parse_space(Config &cfg, TextView content) -> Rv<SpaceHandle>
+Do_ip_space_define::parse_chunk(Chunk &chunk, unsigned line_offset) -> Errata
 {
+  chunk._line_count = line_offset;
   TextView line;
-  unsigned line_no = 0;
-  auto space       = std::make_shared<SpaceInfo>();
-  while (!(line = content.take_prefix_at('\n')).empty()) {
-    ++line_no;
+  TextView content = chunk._content;
+  while (content) {
+    line = content.take_prefix_at('\n');
+    ++chunk._line_count;
     line.trim_if(&isspace);
     if (line.empty() || '#' == line.front()) {
       continue;
     }
-    auto token = line.take_prefix_at(',');
-    IPRange range{token};
-    if (range.empty()) {
-      return Errata(S_ERROR, R"(Invalid range "{}" at line {}.)", token, line_no);
-    }
-
-    Row row = space->arena.alloc(_row_size).rebind<std::byte>();
-    TextView parsed;
-    // Iterate over the columns. If the input data runs out, then @a token becomes the empty
-    // full, which the various cases deal with (in most an empty token isn't a problem).
-    // This guarantees that every column in every row is initialized.
-    for (unsigned col_idx = 1; col_idx < _cols.size(); ++col_idx) {
-      Column &c = _cols[col_idx];
-      MemSpan<void> data{row.data() + c._row_offset, c._row_size};
-      token = line.take_prefix_at(',').ltrim_if(&isspace);
-      switch (c._type) {
-      default:
-        break; // Shouldn't ever happen.
-      case ColumnData::STRING:
-        data.rebind<TextView>()[0] = cfg.localize(token);
-        break;
-      case ColumnData::INTEGER: {
-        if (token) {
-          auto n = swoc::svtoi(token, &parsed);
-          if (parsed.size() == token.size()) {
-            data.rebind<feature_type_for<INTEGER>>()[0] = n;
-          }
-        } else {
-          data.rebind<feature_type_for<INTEGER>>()[0] = 0;
+    if (auto errata = this->parse_line(chunk, line); !errata.is_ok()) {
+      return errata;
+    }
+  }
+  return {};
+}
+
+auto
+Do_ip_space_define::parse_line(Chunk &chunk, TextView line) -> Errata
+{
+  auto token = line.take_prefix_at(',');
+  IPRange range{token};
+  if (range.empty()) {
+    return Errata(S_ERROR, R"(Invalid range "{}" at line {}.)", token, chunk._line_count);
+  }
+
+  Row row = chunk._arena->alloc(_row_size).rebind<std::byte>();
+  TextView parsed;
+  // Iterate over the columns. If the input data runs out, then @a token becomes the empty
+  // full, which the various cases deal with (in most an empty token isn't a problem).
+  // This guarantees that every column in every row is initialized.
+  for (unsigned col_idx = 1; col_idx < _cols.size(); ++col_idx) {
+    Column &c = _cols[col_idx];
+    MemSpan<void> data{row.data() + c._row_offset, c._row_size};
+    token = line.take_prefix_at(',').ltrim_if(&isspace);
+    switch (c._type) {
+    default:
+      break; // Shouldn't ever happen.
+    case ColumnData::STRING:
+      data.rebind<TextView>()[0] = chunk.localize(token);
+      break;
+    case ColumnData::INTEGER: {
+      if (token) {
+        auto n = swoc::svtoi(token, &parsed);
+        if (parsed.size() == token.size()) {
+          data.rebind<feature_type_for<INTEGER>>()[0] = n;
         }
-      } break;
-      case ColumnData::ENUM:
-        if (auto idx = c._tags[token]; INVALID_TAG == idx) {
-          return Errata(S_ERROR, R"("{}" is not a valid tag for column {}{} at line {}.)", token, c._idx, bwf::Optional(R"( "{}")", c._name),
-                       line_no);
-        } else {
-          if (AUTO_TAG == idx) {
-            idx = c._tags.count();
-            c._tags.define(idx, token);
-          }
-          data.rebind<feature_type_for<INTEGER>>()[0] = idx;
+      } else {
+        data.rebind<feature_type_for<INTEGER>>()[0] = 0;
+      }
+    } break;
+    case ColumnData::ENUM: {
+      // Tags are only defined between parses, so this doesn't change while chunks are parsed.
+      if (auto idx = c._tags[token]; INVALID_TAG == idx) {
+        return Errata(S_ERROR, R"("{}" is not a valid tag for column {}{} at line {}.)", token, c._idx, bwf::Optional(R"( "{}")", c._name),
+                     chunk._line_count);
+      } else if (AUTO_TAG == idx) { // defined later, in file order.
+        auto &&[spot, added_p] = chunk._new_tag_idx.emplace(Chunk::TagKey{col_idx, token}, chunk._new_tags.size());
+        if (added_p) {
+          chunk._new_tags.emplace_back(col_idx, token);
         }
-        break;
-      case ColumnData::FLAGS: {
-        TextView key;
-        BitSpan bits{data};
-        bits.reset(); // start with no bits set.
-        while (!(key = token.take_prefix_if([](char c) -> bool { return !('-' == c || '_' == c || isalnum(c)); })).empty()) {
-          if (auto idx = c._tags[key]; idx >= 0) {
-            bits[idx] = true;
-          } else {
-            return Errata(S_ERROR, R"("{}" is not a valid tag for column {}{} at line {}".)", key, c._idx, bwf::Optional(R"( "{}")", c._name),
-                         line_no);
-          }
+        chunk._tag_cells.emplace_back(data.rebind<feature_type_for<INTEGER>>().data(), spot->second);
+      } else {
+        data.rebind<feature_type_for<INTEGER>>()[0] = idx;
+      }
+    } break;
+    case ColumnData::FLAGS: {
+      TextView key;
+      BitSpan bits{data};
+      bits.reset(); // start with no bits set.
+      while (!(key = token.take_prefix_if([](char c) -> bool { return !('-' == c || '_' == c || isalnum(c)); })).empty()) {
+        if (auto idx = c._tags[key]; idx >= 0) {
+          bits[idx] = true;
+        } else {
+          return Errata(S_ERROR, R"("{}" is not a valid tag for column {}{} at line {}".)", key, c._idx, bwf::Optional(R"( "{}")", c._name),
+                       chunk._line_count);
         }
       }
+    }
+    }
+  }
+  chunk._rows.emplace_back(range, row);
+  return {};
+}
+
+void
+Do_ip_space_define::define_tags(Chunk &chunk)
+{
+  std::vector<feature_type_for<INTEGER>> values;
+  values.reserve(chunk._new_tags.size());
+  for (auto const &[col_idx, name] : chunk._new_tags) {
+    auto &tags = _cols[col_idx]._tags;
+    auto idx   = tags[name];
+    if (AUTO_TAG == idx) { // not defined by an earlier chunk.
+      idx = tags.count();
+      tags.define(idx, name);
+    }
+    values.push_back(idx);
+  }
+  for (auto const &[cell, tag_idx] : chunk._tag_cells) {
+    *cell = values[tag_idx];
+  }
+  chunk._new_tags.clear();
+  chunk._new_tag_idx.clear();
+  chunk._tag_cells.clear();
+}
+
+auto
+Do_ip_space_define::apply_delta(SpaceInfo const &base, TextView content) -> Rv<SpaceHandle>
+{
+  if (base.image.data()) {
+    return Errata(S_ERROR, "A delta can not be applied to the binary file for space {}.", _name);
+  }
+
+  auto space         = std::make_shared<SpaceInfo>();
+  space->arenas      = base.arenas; // rows in @a base are used as is.
+  space->delta_count = base.delta_count + 1;
+  Chunk chunk;
+  chunk._arena = space->arenas.emplace_back(std::make_shared<swoc::MemArena>()).get();
+
+  // Parse all of the changes before changing anything. An empty row means remove the range.
+  std::vector<std::pair<IPRange, Row>> changes;
+  TextView line;
+  while (content) {
+    line = content.take_prefix_at('\n');
+    ++chunk._line_count;
+    line.trim_if(&isspace);
+    if (line.empty() || '#' == line.front()) {
+      continue;
+    }
+    auto op = line.front();
+    line.remove_prefix(1);
+    line.ltrim_if(&isspace);
+    if ('+' == op) {
+      if (auto errata = this->parse_line(chunk, line); !errata.is_ok()) {
+        return std::move(errata);
+      }
+      changes.emplace_back(chunk._rows.back());
+    } else if ('-' == op) {
+      auto token = line.take_prefix_at(',');
+      IPRange range{token};
+      if (range.empty()) {
+        return Errata(S_ERROR, R"(Invalid range "{}" at line {}.)", token, chunk._line_count);
+      }
+      changes.emplace_back(range, Row{});
+    } else {
+      return Errata(S_ERROR, R"(Line {} must start with "+" or "-".)", chunk._line_count);
+    }
+  }
+
+  this->define_tags(chunk);
+
+  for (auto &&[range, payload] : base.space) {
+    space->space.mark(range, payload);
+  }
+  for (auto const &[range, row] : changes) {
+    if (row.empty()) {
+      space->space.erase(range);
+    } else {
+      space->space.mark(range, row);
+    }
+  }
+  // Each delta adds an arena and keeps the rows it replaces, bound that by compacting.
+  if (space->delta_count >= MAX_DELTAS) {
+    return this->compact(*space);
+  }
+  return space;
+}
+
+SpaceHandle
+Do_ip_space_define::compact(SpaceInfo const &src)
+{
+  auto space = std::make_shared<SpaceInfo>();
+  Chunk chunk;
+  chunk._arena = space->arenas.emplace_back(std::make_shared<swoc::MemArena>()).get();
+  // Rows are shared by ranges, keep that sharing in the copy.
+  std::unordered_map<std::byte const *, Row> copies;
+  for (auto &&[range, payload] : src.space) {
+    auto &row = copies[payload.data()];
+    if (row.empty()) {
+      row = chunk._arena->alloc(_row_size).rebind<std::byte>();
+      memcpy(row.data(), payload.data(), _row_size);
+      for (auto &c : _cols) {
+        if (c._type == ColumnData::STRING) {
+          auto &text = c.data_in_row(row).rebind<TextView>()[0];
+          text       = chunk.localize(text);
+        }
       }
     }
     space->space.fill(range, row);
@@ -499,6 +1068,319 @@ Do_ip_space_define::parse_space(Config &cfg, TextView content) -> Rv<SpaceHandle
   return space;
 }
 
+auto
+Do_ip_space_define::update_delta(SpaceInfo const &base) -> Rv<SpaceHandle>
+{
+  std::error_code ec;
+  auto mtime = swoc::file::last_write_time(swoc::file::status(_delta_path, ec));
+  if (ec || mtime <= std::max(_last_modified, _delta_modified)) {
+    return SpaceHandle{}; // Not there or not changed.
+  }
+  _delta_modified = mtime;
+  auto content    = swoc::file::load(_delta_path, ec);
+  if (ec) {
+    return Errata(S_ERROR, "Unable to read delta file {} for space {} - {}", _delta_path, _name, ec);
+  }
+  auto &&[space, errata] = this->apply_delta(base, content);
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing delta file "{}" in space "{}".)", _delta_path, _name);
+    return std::move(errata);
+  }
+  return std::move(space);
+}
+
+auto
+Do_ip_space_define::parse_space(TextView content) -> Rv<SpaceHandle>
+{
+  auto space = std::make_shared<SpaceInfo>();
+
+  // Split in to chunks on line boundaries, one per thread. Small files are done in one chunk.
+  size_t n_chunks = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), content.size() / CHUNK_MIN_SIZE));
+  std::vector<Chunk> chunks(n_chunks);
+  size_t chunk_size = content.size() / n_chunks;
+  for (auto &chunk : chunks) {
+    if (&chunk == &chunks.back()) {
+      chunk._content = content;
+    } else {
+      // Take at least @a chunk_size bytes, then up to and including the next newline.
+      auto n         = content.find('\n', std::min(chunk_size, content.size()));
+      chunk._content = content.take_prefix(n == TextView::npos ? content.size() : n + 1);
+    }
+    chunk._arena = space->arenas.emplace_back(std::make_shared<swoc::MemArena>()).get();
+  }
+
+  // Line numbers of the chunks, so errors report the line in the file.
+  std::vector<unsigned> line_offsets(n_chunks, 0);
+  for (size_t idx = 1; idx < n_chunks; ++idx) {
+    auto const &prev  = chunks[idx - 1]._content;
+    line_offsets[idx] = line_offsets[idx - 1] + std::count(prev.begin(), prev.end(), '\n');
+  }
+
+  // Parse the chunks in parallel, using this thread for the first.
+  std::vector<std::thread> threads;
+  std::vector<Errata> errata(n_chunks);
+  for (size_t idx = 1; idx < n_chunks; ++idx) {
+    threads.emplace_back([&, idx]() { errata[idx] = this->parse_chunk(chunks[idx], line_offsets[idx]); });
+  }
+  errata[0] = this->parse_chunk(chunks[0]);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  // Merge in file order, so the result is the same as a sequential parse.
+  for (size_t idx = 0; idx < n_chunks; ++idx) {
+    auto &chunk = chunks[idx];
+    if (!errata[idx].is_ok()) {
+      return std::move(errata[idx]);
+    }
+    this->define_tags(chunk);
+    for (auto const &[range, row] : chunk._rows) {
+      space->space.fill(range, row);
+    }
+  }
+  return space;
+}
+
+Rv<SpaceHandle>
+Do_ip_space_define::load_space()
+{
+  int fd = ::open(_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Errata(S_ERROR, "Unable to open input file {} for space {} - {}", _path, _name,
+                  std::error_code(errno, std::system_category()));
+  }
+  char magic[binary::MAGIC.size()];
+  if (::read(fd, magic, sizeof(magic)) == ssize_t(sizeof(magic)) && binary::MAGIC == TextView(magic, sizeof(magic))) {
+    auto zret = this->map_space(fd);
+    ::close(fd);
+    return zret;
+  }
+  ::close(fd);
+
+  std::error_code ec;
+  auto content = swoc::file::load(_path, ec);
+  if (ec) {
+    return Errata(S_ERROR, "Unable to read input file {} for space {} - {}", _path, _name, ec);
+  }
+  return this->parse_space(content);
+}
+
+Rv<SpaceHandle>
+Do_ip_space_define::map_space(int fd)
+{
+  struct stat st;
+  if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(binary::Header)) {
+    return Errata(S_ERROR, "Binary file {} for space {} is truncated.", _path, _name);
+  }
+  void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return Errata(S_ERROR, "Unable to map binary file {} for space {} - {}", _path, _name,
+                  std::error_code(errno, std::system_category()));
+  }
+  auto space   = std::make_shared<SpaceInfo>();
+  space->image = MemSpan<std::byte>{static_cast<std::byte *>(addr), size_t(st.st_size)};
+
+  auto const &hdr = *space->image.rebind<binary::Header>().data();
+  if (hdr._version != binary::VERSION) {
+    return Errata(S_ERROR, "Binary file {} for space {} has version {}, expected {}.", _path, _name, hdr._version, binary::VERSION);
+  }
+  if (hdr._n_cols != _cols.size() || hdr._row_size != _row_size) {
+    return Errata(S_ERROR, "Binary file {} for space {} has {} columns, the directive has {}.", _path, _name, hdr._n_cols,
+                  _cols.size());
+  }
+
+  // Verify the layout before using any of it.
+  size_t types_offset   = sizeof(binary::Header);
+  size_t ip4_offset     = types_offset + binary::aligned(hdr._n_cols);
+  size_t ip6_offset     = ip4_offset + hdr._n_ip4 * sizeof(binary::Range4);
+  size_t rows_offset    = ip6_offset + hdr._n_ip6 * sizeof(binary::Range6);
+  size_t strings_offset = rows_offset + binary::aligned((hdr._n_ip4 + hdr._n_ip6) * hdr._row_size);
+  if (strings_offset + hdr._strings_size != space->image.size()) {
+    return Errata(S_ERROR, "Binary file {} for space {} has size {}, expected {}.", _path, _name, space->image.size(),
+                  strings_offset + hdr._strings_size);
+  }
+  auto types = space->image.data() + types_offset;
+  for (unsigned idx = 1; idx < _cols.size(); ++idx) {
+    if (ColumnData(types[idx]) != _cols[idx]._type) {
+      return Errata(S_ERROR, "Binary file {} for space {} has type {} for column {}, expected {}.", _path, _name,
+                    Column::TypeNames[ColumnData(types[idx])], idx, Column::TypeNames[_cols[idx]._type]);
+    }
+  }
+
+  space->ip4      = {reinterpret_cast<binary::Range4 const *>(space->image.data() + ip4_offset), size_t(hdr._n_ip4)};
+  space->ip6      = {reinterpret_cast<binary::Range6 const *>(space->image.data() + ip6_offset), size_t(hdr._n_ip6)};
+  space->rows     = space->image.data() + rows_offset;
+  space->row_size = _row_size;
+  space->strings  = TextView{reinterpret_cast<char const *>(space->image.data() + strings_offset), size_t(hdr._strings_size)};
+
+  // Verify the string cells so lookup does not need to.
+  for (size_t r = 0, n = hdr._n_ip4 + hdr._n_ip6; r < n; ++r) {
+    Row row{space->rows + r * _row_size, _row_size};
+    for (auto &c : _cols) {
+      if (c._type == ColumnData::STRING || c._type == ColumnData::ENUM) {
+        auto ref = c.data_in_row(row).rebind<binary::StrRef>()[0];
+        if (size_t(ref._offset) + ref._size > space->strings.size()) {
+          return Errata(S_ERROR, "Binary file {} for space {} has an invalid string in row {}.", _path, _name, r);
+        }
+      }
+    }
+  }
+  return space;
+}
+
+Errata
+Do_ip_space_define::write_binary(swoc::file::path const &path)
+{
+  std::lock_guard update_lock(_update_mutex);
+  auto space = _space_handle;
+  if (!space || space->image.data()) {
+    return Errata(S_ERROR, "Space {} was not loaded from a CSV file.", _name);
+  }
+
+  std::vector<binary::Range4> ip4;
+  std::vector<binary::Range6> ip6;
+  std::vector<Row> ip4_rows;
+  std::vector<Row> ip6_rows;
+  for (auto &&[range, payload] : space->space) {
+    if (range.is_ip4()) {
+      ip4.push_back({range.ip4().min().host_order(), range.ip4().max().host_order()});
+      ip4_rows.push_back(payload);
+    } else {
+      binary::Range6 r;
+      auto min = range.ip6().min().network_order();
+      auto max = range.ip6().max().network_order();
+      memcpy(r._min, &min, sizeof(r._min));
+      memcpy(r._max, &max, sizeof(r._max));
+      ip6.push_back(r);
+      ip6_rows.push_back(payload);
+    }
+  }
+
+  // Convert the rows, moving strings to the string table.
+  std::string strings;
+  std::unordered_map<std::string_view, uint32_t> string_offsets;
+  auto str_ref = [&](TextView text) -> binary::StrRef {
+    if (auto spot = string_offsets.find(text); spot != string_offsets.end()) {
+      return {spot->second, uint32_t(text.size())};
+    }
+    binary::StrRef ref{uint32_t(strings.size()), uint32_t(text.size())};
+    strings.append(text.data(), text.size());
+    string_offsets.emplace(text, ref._offset);
+    return ref;
+  };
+  std::string rows;
+  rows.reserve((ip4_rows.size() + ip6_rows.size()) * _row_size);
+  for (auto const *src : {&ip4_rows, &ip6_rows}) {
+    for (auto const &row : *src) {
+      auto base = rows.size();
+      rows.append(reinterpret_cast<char const *>(row.data()), _row_size);
+      Row out{reinterpret_cast<std::byte *>(rows.data() + base), _row_size};
+      for (auto &c : _cols) {
+        binary::StrRef ref;
+        if (c._type == ColumnData::STRING) {
+          ref = str_ref(c.data_in_row(row).rebind<TextView>()[0]);
+        } else if (c._type == ColumnData::ENUM) {
+          ref = str_ref(c._tags[c.data_in_row(row).rebind<feature_type_for<INTEGER>>()[0]]);
+        } else {
+          continue;
+        }
+        auto cell = c.data_in_row(out);
+        memset(cell, 0);
+        cell.rebind<binary::StrRef>()[0] = ref;
+      }
+    }
+  }
+  if (strings.size() > std::numeric_limits<uint32_t>::max()) {
+    return Errata(S_ERROR, "Space {} has too much string data for the binary format.", _name);
+  }
+
+  binary::Header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr._magic, binary::MAGIC.data(), sizeof(hdr._magic));
+  hdr._version      = binary::VERSION;
+  hdr._row_size     = _row_size;
+  hdr._n_cols       = _cols.size();
+  hdr._n_ip4        = ip4.size();
+  hdr._n_ip6        = ip6.size();
+  hdr._strings_size = strings.size();
+
+  std::string types(binary::aligned(_cols.size()), '\0');
+  for (unsigned idx = 0; idx < _cols.size(); ++idx) {
+    types[idx] = char(_cols[idx]._type);
+  }
+  rows.resize(binary::aligned(rows.size()), '\0');
+
+  // The file may be mapped by a running proxy, so it must be replaced and not rewritten in place.
+  // Write a temporary file in the same directory and rename it over the target.
+  std::string tmp_path;
+  swoc::bwprint(tmp_path, "{}.tmp.{}", path, ::getpid());
+  int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return Errata(S_ERROR, "Unable to open temporary file {} for space {} - {}", tmp_path, _name,
+                  std::error_code(errno, std::system_category()));
+  }
+  auto write_all = [fd](void const *data, size_t size) -> bool {
+    auto src = static_cast<char const *>(data);
+    while (size > 0) {
+      auto n = ::write(fd, src, size);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      src  += n;
+      size -= n;
+    }
+    return true;
+  };
+  bool ok = write_all(&hdr, sizeof(hdr)) && write_all(types.data(), types.size()) &&
+            write_all(ip4.data(), ip4.size() * sizeof(binary::Range4)) && write_all(ip6.data(), ip6.size() * sizeof(binary::Range6)) &&
+            write_all(rows.data(), rows.size()) && write_all(strings.data(), strings.size()) && 0 == ::fsync(fd);
+  std::error_code ec{ok ? 0 : errno, std::system_category()};
+  if (0 != ::close(fd) && ok) {
+    ok = false;
+    ec = std::error_code(errno, std::system_category());
+  }
+  if (ok && 0 != ::rename(tmp_path.c_str(), path.c_str())) {
+    ok = false;
+    ec = std::error_code(errno, std::system_category());
+  }
+  if (!ok) {
+    ::unlink(tmp_path.c_str());
+    return Errata(S_ERROR, "Unable to write binary file {} for space {} - {}", path, _name, ec);
+  }
+  return {};
+}
+
+/** Write all spaces in a configuration in the binary format.
+ *
+ * @param cfg Loaded configuration.
+ * @param dir Output directory.
+ * @return Errors, if any.
+ *
+ * Each space is written to a file in @a dir with the space name and the extension ".ipsb". This is
+ * used by the configuration checker to convert CSV files.
+ */
+Errata
+IP_Space_Write_Binary(Config &cfg, swoc::file::path const &dir)
+{
+  auto cfg_info = Txb_IP_Space::cfg_info(cfg);
+  if (!cfg_info || cfg_info->_map.empty()) {
+    return Errata(S_ERROR, "Configuration does not define an IP space.");
+  }
+  for (auto &[name, drtv] : cfg_info->_map) {
+    swoc::file::path path{dir};
+    path /= std::string(name) + ".ipsb";
+    auto errata = drtv->write_binary(path);
+    if (!errata.is_ok()) {
+      return errata;
+    }
+    ts::DebugMsg("Wrote space {} to {}.", name, path);
+  }
+  return {};
+}
+
 Errata
 Do_ip_space_define::define_column(Config &cfg, YAML::Node node)
 {
@@ -574,6 +1456,10 @@ Do_ip_space_define::define_column(Config &cfg, YAML::Node node)
       }
     }
   }
+  if (ColumnData::FLAGS == col._type && col._tags.count() > std::numeric_limits<feature_type_for<INTEGER>>::digits + 1) {
+    return Errata(S_ERROR, "{} at {} has {} values, at most {} are allowed for type {}.", COLUMNS_TAG, node.Mark(), col._tags.count(),
+                  std::numeric_limits<feature_type_for<INTEGER>>::digits + 1, Column::TypeNames[ColumnData::FLAGS]);
+  }
   col._idx        = _cols.size();
   col._row_offset = _row_size;
   switch (col._type) {
@@ -636,6 +1522,20 @@ Do_ip_space_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   self->_path = std::get<IndexFor(STRING)>(std::get<Expr::LITERAL>(path_expr._raw));
   ts::make_absolute(self->_path);
 
+  if (auto delta_node = key_value[DELTA_TAG]; delta_node) {
+    auto &&[delta_expr, delta_errata]{cfg.parse_expr(delta_node)};
+    if (!delta_errata.is_ok()) {
+      delta_errata.note("While parsing {} directive at {}.", KEY, drtv_node.Mark());
+      return std::move(delta_errata);
+    }
+    if (!delta_expr.is_literal() || !delta_expr.result_type().can_satisfy(STRING)) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a literal string.", DELTA_TAG, delta_node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    self->_delta_path = std::get<IndexFor(STRING)>(std::get<Expr::LITERAL>(delta_expr._raw));
+    ts::make_absolute(self->_delta_path);
+  }
+
   auto dur_node = key_value[DURATION_TAG];
   if (dur_node) {
     auto &&[dur_expr, dur_errata] = cfg.parse_expr(dur_node);
@@ -656,6 +1556,19 @@ Do_ip_space_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
     drtv_node.remove(dur_node);
   }
 
+  if (auto cache_node = key_value[CACHE_TAG]; cache_node) {
+    auto &&[cache_expr, cache_errata] = cfg.parse_expr(cache_node);
+    if (!cache_errata.is_ok()) {
+      cache_errata.note("While parsing {} directive at {}.", KEY, drtv_node.Mark());
+      return std::move(cache_errata);
+    }
+    if (!cache_expr.is_literal()) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a literal boolean.", CACHE_TAG, cache_node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    self->_cache_p = std::get<Expr::LITERAL>(cache_expr._raw).as_bool();
+  }
+
   auto cols_node = key_value[COLUMNS_TAG];
   // To simplify indexing, put in a "range" column as index 0, so config indices and internal
   // indices match up.
@@ -686,17 +1599,22 @@ Do_ip_space_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   }
 
   std::error_code ec;
-  auto content = swoc::file::load(self->_path, ec);
-  if (ec) {
-    return Errata(S_ERROR, "Unable to read input file {} for space {} - {}", self->_path, self->_name, ec);
-  }
   self->_last_modified              = swoc::file::last_write_time(swoc::file::status(self->_path, ec));
-  auto &&[space_info, space_errata] = self->parse_space(cfg, content);
+  auto &&[space_info, space_errata] = self->load_space();
   if (!space_errata.is_ok()) {
     space_errata.note(R"(While parsing IPSpace file "{}" in space "{}".)", self->_path, self->_name);
     return std::move(space_errata);
   }
-  self->_space = space_info;
+  if (!self->_delta_path.empty()) {
+    auto &&[delta_info, delta_errata] = self->update_delta(*space_info);
+    if (!delta_errata.is_ok()) {
+      return std::move(delta_errata);
+    }
+    if (delta_info) {
+      space_info = delta_info;
+    }
+  }
+  self->publish(Txb_IP_Space::cfg_info(cfg)->_epoch, space_info);
 
   // Put the directive in the map.
   Map & map = Txb_IP_Space::cfg_info(cfg)->_map;
@@ -717,6 +1635,7 @@ Do_ip_space_define::cfg_init(Config &cfg, CfgStaticData const *)
   // Only one space can be active at a time therefore this can be shared among the instances in
   // a single @c Context.
   cfg_info->_ctx_reserved_span = cfg.reserve_ctx_storage(sizeof(CtxActiveInfo));
+  cfg_info->_ctx_held_span     = cfg.reserve_ctx_storage(sizeof(HeldSpace *));
   cfg.mark_for_cleanup(cfg_info); // takes a pointer to the object to clean up.
   return {};
 }
@@ -729,26 +1648,39 @@ Do_ip_space_define::Updater::operator()()
     return;
   }
 
-  if (!_block->should_check()) {
+  auto &epoch = Txb_IP_Space::cfg_info(*cfg)->_epoch;
+  epoch.reclaim(); // Clean up replaced spaces no longer used by transactions.
+
+  if (!_watch_p && !_block->should_check()) {
     return; // not time yet.
   }
 
+  // The file watch and the periodic check can run at the same time.
+  std::lock_guard update_lock(_block->_update_mutex);
+
   std::error_code ec;
   auto fs = swoc::file::status(_block->_path, ec);
   if (!ec) {
     auto mtime = swoc::file::last_write_time(fs);
-    if (mtime <= _block->_last_modified) {
-      return; // same as it ever was...
-    }
-    std::string content = swoc::file::load(_block->_path, ec);
-    if (!ec) { // swap in updated content.
-      auto &&[space, errata]{_block->parse_space(*cfg, content)};
-      if (errata.is_ok()) {
-        std::unique_lock lock(_block->_space_mutex);
-        _block->_space = space;
+    if (mtime > _block->_last_modified) {
+      auto &&[space, errata]{_block->load_space()};
+      if (errata.is_ok()) { // swap in updated content.
+        _block->publish(epoch, space);
       }
       _block->_last_modified = mtime;
-      return;
+    }
+  }
+
+  // A delta is applied to the current space, which may have just been reloaded.
+  if (!_block->_delta_path.empty()) {
+    if (auto base = _block->_space_handle; base) {
+      auto &&[space, errata]{_block->update_delta(*base)};
+      if (!errata.is_ok()) {
+        std::string text;
+        ts::Log_Error(swoc::bwprint(text, "{}: {}", Config::PLUGIN_TAG, errata));
+      } else if (space) {
+        _block->publish(epoch, space);
+      }
     }
   }
 }
@@ -765,11 +1697,45 @@ Do_ip_space_define::col_idx(TextView const &name)
   return INVALID_IDX;
 }
 
-SpaceHandle
-Do_ip_space_define::acquire_space()
+SpaceInfo *
+Do_ip_space_define::acquire_space(Context &ctx)
 {
-  std::shared_lock lock(_space_mutex);
-  return _space;
+  auto info = Txb_IP_Space::cfg_info(ctx.cfg());
+  if (nullptr == info) {
+    return nullptr;
+  }
+  auto &held = ctx.storage_for(info->_ctx_held_span).rebind<HeldSpace *>()[0];
+  for (auto spot = held; spot; spot = spot->_next) {
+    if (spot->_drtv == this) {
+      return spot->_space.get();
+    }
+  }
+
+  SpaceHandle space;
+  { // Must be in the epoch to load the space pointer, but only until there is a reference.
+    auto guard = info->_epoch.enter();
+    if (auto ptr = _space.load(std::memory_order_acquire); ptr) {
+      space = ptr->shared_from_this();
+    }
+  }
+  if (!space) {
+    return nullptr;
+  }
+  auto spot    = ctx.make<HeldSpace>();
+  spot->_drtv  = this;
+  spot->_space = std::move(space);
+  spot->_next  = held;
+  held         = spot;
+  ctx.mark_for_cleanup(spot); // release the space when the txn is done.
+  return spot->_space.get();
+}
+
+void
+Do_ip_space_define::publish(Epoch &epoch, SpaceHandle space)
+{
+  _space.store(space.get(), std::memory_order_release);
+  std::swap(_space_handle, space);
+  epoch.retire(std::move(space)); // previous space.
 }
 /* ------------------------------------------------------------------------------------ */
 /// IPSpace modifier
@@ -780,6 +1746,14 @@ class Mod_ip_space : public Modifier
   using super_type = Modifier;     ///< Parent type.
 
 public:
+  /// Result selection for a tuple of addresses.
+  enum Select {
+    ALL,   ///< Tuple of the results for every address.
+    FIRST, ///< Result for the first address that is in the space.
+    MAX,   ///< Result for the address with the largest value in a column.
+    MIN    ///< Result for the address with the smallest value in a column.
+  };
+
   Mod_ip_space(Expr &&expr, TextView const &view, Do_ip_space_define *drtv);
 
   static inline constexpr swoc::TextView KEY{"ip-space"};
@@ -788,6 +1762,16 @@ public:
     Do_ip_space_define *_drtv = nullptr;
   };
 
+  /** Modify the feature.
+   *
+   * @param ctx Run time context.
+   * @param feature Feature to modify [in,out]
+   * @return Errors, if any.
+   *
+   * A tuple of addresses is handled as a batch.
+   */
+  Rv<Feature> operator()(Context &ctx, Feature &feature) override;
+
   /** Modify the feature.
    *
    * @param ctx Run time context.
@@ -819,6 +1803,32 @@ protected:
   Expr _expr;                          ///< Value expression.
   TextView _name;                      ///< Argument - IPSpace name.
   Do_ip_space_define *_drtv = nullptr; ///< The IPSpace define for @a _name
+  Select _select            = ALL;     ///< Result for a tuple of addresses.
+  TextView _col_name;                  ///< Column for @c MAX or @c MIN.
+  unsigned _col_idx = Do_ip_space_define::INVALID_IDX; ///< Column index, if known at load.
+
+  static inline const swoc::Lexicon<Select> SelectNames{
+    {{ALL, "all"}, {FIRST, "first"}, {MAX, "max"}, {MIN, "min"}}, ALL
+  };
+
+  /// Find the directive for the space.
+  Do_ip_space_define *drtv(Context &ctx);
+
+  /** Evaluate the expression for a row.
+   *
+   * @param ctx Run time context.
+   * @param active Active space data.
+   * @return The value of the expression.
+   */
+  Feature eval(Context &ctx, CtxActiveInfo const &active);
+
+  /** Modify a tuple of addresses.
+   *
+   * @param ctx Run time context.
+   * @param tuple Addresses to look up.
+   * @return The selected result, or a tuple of results.
+   */
+  Rv<Feature> batch(Context &ctx, feature_type_for<TUPLE> tuple);
 };
 
 Mod_ip_space::Mod_ip_space(Expr &&expr, TextView const &name, Do_ip_space_define *drtv)
@@ -829,30 +1839,54 @@ Mod_ip_space::Mod_ip_space(Expr &&expr, TextView const &name, Do_ip_space_define
 bool
 Mod_ip_space::is_valid_for(ActiveType const &ex_type) const
 {
-  return ex_type.can_satisfy(IP_ADDR);
+  return ex_type.can_satisfy(IP_ADDR) || ex_type.can_satisfy(TUPLE);
 }
 
 ActiveType
 Mod_ip_space::result_type(const ActiveType &) const
 {
-  return {NIL, STRING, INTEGER, ActiveType::TupleOf(STRING)};
+  return {NIL, STRING, INTEGER, TUPLE, ActiveType::TupleOf(STRING)};
 }
 
 Rv<Modifier::Handle>
 Mod_ip_space::load(Config &cfg, YAML::Node node, TextView, TextView arg, YAML::Node key_value)
 {
+  // Argument is the space name, optionally followed by the selection for a tuple of addresses.
+  auto name   = arg.take_prefix_at(',').trim_if(&isspace);
+  auto select = arg.take_prefix_at(':').trim_if(&isspace);
+  auto col    = arg.trim_if(&isspace);
+  Select sel  = ALL;
+  if (!select.empty()) {
+    sel = SelectNames[select];
+    if (sel == ALL && 0 != strcasecmp(select, SelectNames[ALL])) {
+      return Errata(S_ERROR, R"("{}" at {} is not a valid selection - must be one of {:s}.)", select, node.Mark(), SelectNames);
+    }
+  }
+  if ((sel == MAX || sel == MIN) == col.empty()) {
+    return Errata(S_ERROR, R"(A column must be specified at {} for, and only for, the "{}" and "{}" selections.)", node.Mark(),
+                  SelectNames[MAX], SelectNames[MIN]);
+  }
+
   auto *csi = Txb_IP_Space::cfg_info(cfg);
   CfgActiveInfo info;
   // Unfortunately supporting remap requires dynamic access.
   if (csi) { // global, resolve to the specific ipspace directive.
     auto &map = csi->_map;
-    auto spot = map.find(arg);
+    auto spot = map.find(name);
     if (spot == map.end()) {
-      return Errata(S_ERROR, R"("{}" at {} is not the name of a defined IP space.)", arg, node.Mark());
+      return Errata(S_ERROR, R"("{}" at {} is not the name of a defined IP space.)", name, node.Mark());
     }
     info._drtv = spot->second;
   } // else leave @a _drtv null as a signal to find it dynamically.
 
+  unsigned col_idx = Do_ip_space_define::INVALID_IDX;
+  if (!col.empty() && info._drtv) {
+    col_idx = info._drtv->col_idx(col);
+    if (col_idx == Do_ip_space_define::INVALID_IDX || info._drtv->_cols[col_idx]._type != ColumnData::INTEGER) {
+      return Errata(S_ERROR, R"("{}" at {} is not an integer column in space "{}".)", col, node.Mark(), name);
+    }
+  }
+
   // Make info about active space available to expression parsing.
   auto scope{cfg.active_value_let(KEY, &info)};
   auto &&[expr, errata]{cfg.parse_expr(key_value)};
@@ -861,7 +1895,45 @@ Mod_ip_space::load(Config &cfg, YAML::Node node, TextView, TextView arg, YAML::N
     errata.note(R"(While parsing "{}" modifier at {}.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(expr), cfg.localize(arg), info._drtv});
+  auto self       = new self_type{std::move(expr), cfg.localize(name), info._drtv};
+  self->_select   = sel;
+  self->_col_name = cfg.localize(col);
+  self->_col_idx  = col_idx;
+  return Handle(self);
+}
+
+Do_ip_space_define *
+Mod_ip_space::drtv(Context &ctx)
+{
+  if (_drtv) {
+    return _drtv;
+  }
+  if (auto *csi = Txb_IP_Space::cfg_info(ctx.cfg()); nullptr != csi) {
+    auto &map = csi->_map;
+    if (auto spot = map.find(_name); spot != map.end()) {
+      return spot->second;
+    }
+  }
+  return nullptr;
+}
+
+Feature
+Mod_ip_space::eval(Context &ctx, CtxActiveInfo const &active)
+{
+  // Current active data.
+  auto *store = Txb_IP_Space::ctx_active_info(ctx);
+  // Temporarily update it to local conditions.
+  let scope(*store, active);
+  return ctx.extract(_expr);
+}
+
+Rv<Feature>
+Mod_ip_space::operator()(Context &ctx, Feature &feature)
+{
+  if (auto t = std::get_if<IndexFor(TUPLE)>(&feature); nullptr != t) {
+    return this->batch(ctx, *t);
+  }
+  return super_type::operator()(ctx, feature);
 }
 
 Rv<Feature>
@@ -869,32 +1941,118 @@ Mod_ip_space::operator()(Context &ctx, feature_type_for<IP_ADDR> addr)
 {
   // Set up local active state.
   CtxActiveInfo active;
-  auto drtv = _drtv; // may be locally updated, need a copy.
-  if (drtv) {
-    active._space = drtv->acquire_space();
-  } else {
-    if (auto *csi = Txb_IP_Space::cfg_info(ctx.cfg()); nullptr != csi) {
-      auto &map = csi->_map;
-      if (auto spot = map.find(_name); spot != map.end()) {
-        drtv          = spot->second;
-        active._space = drtv->acquire_space();
+  active._drtv  = this->drtv(ctx);
+  active._space = active._drtv ? active._drtv->acquire_space(ctx) : nullptr;
+  if (active._space) {
+    SpaceInfo::Hint hint;
+    active._row  = active._drtv->find(*active._space, addr, hint);
+    active._addr = addr;
+    return this->eval(ctx, active);
+  }
+  return Feature{FeatureView::Literal("")};
+}
+
+Rv<Feature>
+Mod_ip_space::batch(Context &ctx, feature_type_for<TUPLE> tuple)
+{
+  CtxActiveInfo active;
+  active._drtv  = this->drtv(ctx);
+  active._space = active._drtv ? active._drtv->acquire_space(ctx) : nullptr;
+  if (!active._space) { // Nothing to look up in, every result is NIL.
+    if (_select == ALL) {
+      auto t = ctx.alloc_span<Feature>(tuple.count());
+      for (auto &f : t) {
+        f = NIL_FEATURE;
       }
+      return Feature{t};
     }
+    return NIL_FEATURE;
   }
-  Feature value{FeatureView::Literal("")};
-  if (active._space) {
-    auto &&[range, payload] = *active._space->space.find(addr);
-    active._row             = range.empty() ? nullptr : &payload;
-    active._addr            = addr;
-    active._drtv            = drtv;
-
-    // Current active data.
-    auto * store = Txb_IP_Space::ctx_active_info(ctx);
-    // Temporarily update it to local conditions.
-    let scope(*store, active);
-    value = ctx.extract(_expr);
-  }
-  return value;
+
+  // Look up in address order so the searches share the narrowing search range.
+  struct Item {
+    IPAddr _addr;  ///< Address.
+    unsigned _idx; ///< Index in @a tuple.
+    Row _row;      ///< Lookup result.
+  };
+  auto items = ctx.alloc_span<Item>(tuple.count(), alignof(Item));
+  unsigned n = 0;
+  for (unsigned idx = 0; idx < tuple.count(); ++idx) {
+    IPAddr addr;
+    if (auto a = std::get_if<IndexFor(IP_ADDR)>(&tuple[idx]); nullptr != a) {
+      addr = *a;
+    } else if (auto text = std::get_if<IndexFor(STRING)>(&tuple[idx]); nullptr == text || !addr.load(TextView(*text).trim_if(&isspace))) {
+      continue; // not an address, the result for it is NIL.
+    }
+    new (&items[n++]) Item{addr, idx, {}};
+  }
+  items = items.prefix(n);
+  auto order = [](Item const &lhs, Item const &rhs) -> bool {
+    if (lhs._addr.family() != rhs._addr.family()) {
+      return lhs._addr.is_ip4(); // IPv4 first.
+    }
+    if (lhs._addr.is_ip4()) {
+      return lhs._addr.ip4().host_order() < rhs._addr.ip4().host_order();
+    }
+    auto l6 = lhs._addr.ip6().network_order();
+    auto r6 = rhs._addr.ip6().network_order();
+    return memcmp(&l6, &r6, sizeof(l6)) < 0;
+  };
+  std::sort(items.begin(), items.end(), order);
+  SpaceInfo::Hint hint;
+  for (unsigned k = 0; k < n; ++k) {
+    auto &item = items[k];
+    item._row  = (k > 0 && item._addr == items[k - 1]._addr) ? items[k - 1]._row : active._drtv->find(*active._space, item._addr, hint);
+  }
+  // Restore the original order for selection and results.
+  std::sort(items.begin(), items.end(), [](Item const &lhs, Item const &rhs) { return lhs._idx < rhs._idx; });
+
+  if (_select == ALL) {
+    // Elements that are not addresses keep their position, with a NIL result.
+    auto t = ctx.alloc_span<Feature>(tuple.count());
+    for (auto &f : t) {
+      f = NIL_FEATURE;
+    }
+    for (auto &item : items) {
+      active._row  = item._row;
+      active._addr = item._addr;
+      auto value   = this->eval(ctx, active);
+      t[item._idx] = ctx.commit(value); // must persist past the next evaluation.
+    }
+    return Feature{t};
+  }
+
+  // Select a single address.
+  unsigned col_idx = _col_idx;
+  if (col_idx == Do_ip_space_define::INVALID_IDX && !_col_name.empty()) {
+    col_idx = active._drtv->col_idx(_col_name);
+    if (col_idx == Do_ip_space_define::INVALID_IDX || active._drtv->_cols[col_idx]._type != ColumnData::INTEGER) {
+      return Errata(S_ERROR, R"("{}" is not an integer column in space "{}".)", _col_name, active._drtv->_name);
+    }
+  }
+  Item *selected = nullptr;
+  feature_type_for<INTEGER> best = 0;
+  for (auto &item : items) {
+    if (item._row.empty()) {
+      continue;
+    }
+    if (_select == FIRST) {
+      selected = &item;
+      break;
+    }
+    auto value = active._drtv->_cols[col_idx].data_in_row(item._row).rebind<feature_type_for<INTEGER>>()[0];
+    if (!selected || (_select == MAX ? value > best : value < best)) {
+      selected = &item;
+      best     = value;
+    }
+  }
+  if (selected) {
+    active._row  = selected->_row;
+    active._addr = selected->_addr;
+  } else if (n > 0) { // no match, evaluate as not found.
+    active._addr = items[0]._addr;
+  }
+  return this->eval(ctx, active);
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -986,19 +2144,20 @@ Ex_ip_col::extract(Context &ctx, const Spec &spec)
     auto idx  = (info->_idx != INVALID_IDX ? info->_idx : ctx_ai->_drtv->col_idx(info->_arg));
     if (idx != INVALID_IDX) { // Column is valid.
       auto &col = ctx_ai->_drtv->_cols[idx];
-      if (ctx_ai->_row) {
-        auto data = col.data_in_row(ctx_ai->_row);
+      if (!ctx_ai->_row.empty()) {
+        auto data     = col.data_in_row(ctx_ai->_row);
+        bool binary_p = ctx_ai->_space->image.data() != nullptr;
         switch (col._type) {
         default:
           break; // Shouldn't happen.
         case ColumnData::ADDRESS:
           return {ctx_ai->_addr};
         case ColumnData::STRING:
-          return FeatureView::Literal(data.rebind<TextView>()[0]);
+          return FeatureView::Literal(binary_p ? ctx_ai->_space->text(data) : data.rebind<TextView>()[0]);
         case ColumnData::INTEGER:
           return {data.rebind<feature_type_for<INTEGER>>()[0]};
         case ColumnData::ENUM:
-          return FeatureView::Literal(col._tags[data.rebind<unsigned>()[0]]);
+          return FeatureView::Literal(binary_p ? ctx_ai->_space->text(data) : col._tags[data.rebind<unsigned>()[0]]);
         case ColumnData::FLAGS: {
           auto bits   = BitSpan(data);
           auto n_bits = bits.count();
@@ -1017,15 +2176,141 @@ Ex_ip_col::extract(Context &ctx, const Spec &spec)
   return NIL_FEATURE;
 }
 
+/* ------------------------------------------------------------------------------------ */
+/** Test a flags column against a set of flags.
+ *
+ * The flags for a column are stored in a single word, therefore the test is a single load and
+ * mask operation.
+ */
+class Ex_ip_col_flags : public Extractor
+{
+  using self_type  = Ex_ip_col_flags; ///< Self reference type.
+  using super_type = Extractor;       ///< Parent type.
+
+public:
+  static constexpr TextView ANY_NAME{"ip-col-any"}; ///< Any of the flags are set.
+  static constexpr TextView ALL_NAME{"ip-col-all"}; ///< All of the flags are set.
+
+  /** Constructor.
+   *
+   * @param all_p @c true if all flags must be set, @c false if any.
+   */
+  explicit Ex_ip_col_flags(bool all_p) : _all_p(all_p) {}
+
+  Rv<ActiveType> validate(Config &cfg, Spec &spec, TextView const &arg) override;
+
+  Feature extract(Context &ctx, Spec const &spec) override;
+
+protected:
+  using Word                        = feature_type_for<INTEGER>; ///< Flags column storage.
+  static constexpr auto INVALID_IDX = Do_ip_space_define::INVALID_IDX;
+
+  struct Info {
+    unsigned _idx = INVALID_IDX; ///< Column index.
+    Word _mask    = 0;           ///< Flags to test.
+    TextView _arg;               ///< Argument for use in remap / lazy lookup.
+  };
+
+  bool _all_p; ///< Test for all flags, not any.
+
+  /** Compute the flag mask.
+   *
+   * @param drtv Space directive.
+   * @param arg Column and flag names.
+   * @param info [out] Column index and mask.
+   * @return Errors, if any.
+   */
+  static Errata resolve(Do_ip_space_define *drtv, TextView arg, Info &info);
+};
+
+Errata
+Ex_ip_col_flags::resolve(Do_ip_space_define *drtv, TextView arg, Info &info)
+{
+  TextView parsed;
+  auto col = arg.take_prefix_at(',').trim_if(&isspace);
+  if (auto n = svtou(col, &parsed); col.size() == parsed.size()) {
+    info._idx = n < drtv->_cols.size() ? n : INVALID_IDX;
+  } else {
+    info._idx = drtv->col_idx(col);
+  }
+  if (info._idx == INVALID_IDX || drtv->_cols[info._idx]._type != ColumnData::FLAGS) {
+    return Errata(S_ERROR, R"("{}" is not a flags column in space {}.)", col, drtv->_name);
+  }
+
+  // Set the bits in the mask the same way they are set in the row.
+  auto &c = drtv->_cols[info._idx];
+  info._mask = 0;
+  BitSpan bits{MemSpan<void>{&info._mask, sizeof(info._mask)}};
+  while (arg.ltrim_if(&isspace)) {
+    auto tag = arg.take_prefix_at(',').rtrim_if(&isspace);
+    if (auto idx = c._tags[tag]; idx >= 0) {
+      bits[idx] = true;
+    } else {
+      return Errata(S_ERROR, R"("{}" is not a valid tag for column {} in space {}.)", tag, col, drtv->_name);
+    }
+  }
+  if (info._mask == 0) {
+    return Errata(S_ERROR, R"(No flags were specified for column {} in space {}.)", col, drtv->_name);
+  }
+  return {};
+}
+
+Rv<ActiveType>
+Ex_ip_col_flags::validate(Config &cfg, Spec &spec, TextView const &arg)
+{
+  auto name = _all_p ? ALL_NAME : ANY_NAME;
+  if (arg.empty()) {
+    return Errata(S_ERROR, R"("{}" extractor requires an argument to specify the column and flags.)", name);
+  }
+
+  auto *mod_info = cfg.active_value<Mod_ip_space::CfgActiveInfo>(Mod_ip_space::KEY);
+  if (!mod_info) {
+    return Errata(S_ERROR, R"("{}" extractor can only be used with an active IP Space from the {} modifier.)", name, Mod_ip_space::KEY);
+  }
+
+  auto span       = cfg.allocate_cfg_storage(sizeof(Info)).rebind<Info>();
+  spec._data.span = span;
+  Info &info      = span[0];
+  new (&info) Info;
+  if (auto drtv = mod_info->_drtv; drtv) {
+    if (auto errata = self_type::resolve(drtv, arg, info); !errata.is_ok()) {
+      return std::move(errata);
+    }
+  } else { // remap - resolve when used.
+    info._arg = cfg.localize(arg);
+  }
+  return {BOOLEAN};
+}
+
+Feature
+Ex_ip_col_flags::extract(Context &ctx, Spec const &spec)
+{
+  if (auto ctx_ai = Txb_IP_Space::ctx_active_info(ctx); ctx_ai && !ctx_ai->_row.empty()) {
+    Info info = spec._data.span.rebind<Info>()[0];
+    if (info._idx == INVALID_IDX && !self_type::resolve(ctx_ai->_drtv, info._arg, info).is_ok()) {
+      return NIL_FEATURE;
+    }
+    Word word;
+    memcpy(&word, ctx_ai->_row.data() + ctx_ai->_drtv->_cols[info._idx]._row_offset, sizeof(word));
+    word &= info._mask;
+    return feature_type_for<BOOLEAN>{_all_p ? word == info._mask : word != 0};
+  }
+  return feature_type_for<BOOLEAN>{false};
+}
+
 /* ------------------------------------------------------------------------------------ */
 
 namespace
 {
 Ex_ip_col ex_ip_col;
+Ex_ip_col_flags ex_ip_col_any{false};
+Ex_ip_col_flags ex_ip_col_all{true};
 [[maybe_unused]] bool INITIALIZED = []() -> bool {
   Config::define<Do_ip_space_define>();
   Modifier::define(Mod_ip_space::KEY, Mod_ip_space::load);
   Extractor::define(ex_ip_col.NAME, &ex_ip_col);
+  Extractor::define(Ex_ip_col_flags::ANY_NAME, &ex_ip_col_any);
+  Extractor::define(Ex_ip_col_flags::ALL_NAME, &ex_ip_col_all);
   return true;
 }();
 } // namespace
@@ -484,7 +484,7 @@ protected:
 
     bool operator()(Context &ctx, Feature const &feature);
 
-    Errata pre_load(Config &cfg, YAML::Node node);
+    Rv<unsigned> pre_load(Config &cfg, YAML::Node node);
 
     Errata parse_pair(Config &cfg, YAML::Node node, PairExpr & pair);
     void eval_pair(Context & ctx, PairExpr const& pe, QPair & qp) const;
@@ -588,7 +588,7 @@ Mod_query_filter::Case::parse_pair(Config &cfg, YAML::Node node, PairExpr &pair)
   return {};
 }
 
-Errata
+Rv<unsigned>
 Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
   unsigned action_count = 0;
 
@@ -603,13 +603,11 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
   YAML::Node drop_node = cmp_node[ACTION_DROP];
   if (drop_node) {
     _action = DROP;
-    cmp_node.remove(ACTION_DROP);
     ++action_count;
   }
 
   if (YAML::Node pass_node = cmp_node[ACTION_PASS] ; pass_node) {
     _action = PASS;
-    cmp_node.remove(ACTION_PASS);
     ++action_count;
   }
 
@@ -618,10 +616,9 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
     if (!errata.is_ok()) {
       errata.note("While parsing expression at {} for {} key in comparison at {}.", replace_node.Mark(), ACTION_REPLACE,
                   cmp_node.Mark());
-      return errata;
+      return std::move(errata);
     }
     _action = REPLACE;
-    cmp_node.remove(ACTION_REPLACE);
     ++action_count;
   }
 
@@ -630,8 +627,10 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
                  cmp_node.Mark());
   }
 
+  unsigned key_count = action_count;
   YAML::Node opt_node = cmp_node[ACTION_OPT];
   if (opt_node) {
+    ++key_count;
     if (!opt_node.IsMap()) {
       return Errata(S_ERROR,R"("Value for "{}" at {} for "{}" modifier is not an object.)", ACTION_OPT, opt_node.Mark(), KEY);
     }
@@ -663,7 +662,7 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
     }
     if (! errata.is_ok()) {
       errata.note("While parsing {} expressions.", OPT_APPEND);
-      return errata;
+      return std::move(errata);
     }
 
     if (auto pass_rest_node = opt_node[OPT_PASS_REST] ; pass_rest_node) {
@@ -678,11 +677,9 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
       _opt_rest = Case::REST_DROP;
       opt_node.remove(drop_rest_node);
     }
-
-    cmp_node.remove(opt_node);
   }
 
-  return {};
+  return key_count;
 }
 
 Rv<Modifier::Handle> Mod_query_filter::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
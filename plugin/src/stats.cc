@@ -12,6 +12,7 @@
 #include <swoc/TextView.h>
 #include <swoc/Errata.h>
 #include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
 
 #include "txn_box/Config.h"
 #include "txn_box/Directive.h"
@@ -57,14 +58,60 @@ public:
 
   static Errata cfg_init(Config &cfg, CfgStaticData const *rtti);
 
+  /** Find a histogram.
+   *
+   * @param cfg Configuration instance.
+   * @param name Stat name in configuration.
+   * @return The histogram for @a name if defined as a histogram, @c nullptr if not.
+   */
+  static ts::HistogramStat *histogram(Config &cfg, TextView const &name);
+
+  /** Find a batched stat.
+   *
+   * @param cfg Configuration instance.
+   * @param name Stat name in configuration.
+   * @return The accumulator for @a name if defined as batched, @c nullptr if not.
+   */
+  static ts::ShardedStat *batched(Config &cfg, TextView const &name);
+
+  /** Check an update of a stat.
+   *
+   * @param cfg Configuration instance.
+   * @param name Stat name in configuration.
+   * @param mark Location of the update.
+   * @return Errors if @a name is a histogram defined in another configuration.
+   *
+   * Histograms and batched stats are resolved during load, therefore one of those defined after an update in the same
+   * configuration is an error. The update is recorded here for checking when stats are defined.
+   */
+  static Errata check_update(Config &cfg, TextView const &name, YAML::Mark const &mark);
+
 protected:
   /// Mapping internal names to full names.
   using Names = std::unordered_map<TextView, TextView, std::hash<std::string_view>>;
+  /// Mapping internal names to histograms.
+  using Histograms = std::unordered_map<TextView, ts::HistogramStat *, std::hash<std::string_view>>;
+  /// Mapping internal names to batched stats.
+  using Batched = std::unordered_map<TextView, ts::ShardedStat *, std::hash<std::string_view>>;
+  /// Mapping names to the first update.
+  using Updates = std::unordered_map<TextView, YAML::Mark, std::hash<std::string_view>>;
   /// Data in reserved configuration storage.
   struct CfgInfo {
-    Names _names; ///< Map of internal names to full names.
+    Names _names;           ///< Map of internal names to full names.
+    Histograms _histograms; ///< Map of internal names to histograms.
+    Batched _batched;       ///< Map of internal names to batched stats.
+    Updates _updates;       ///< Stats updated before being defined.
   };
 
+  /** Get the configuration level information.
+   *
+   * @param cfg Configuration instance.
+   * @return The information for @a cfg, created if needed.
+   *
+   * This can be needed before any stat is defined, to record updates.
+   */
+  static CfgInfo *cfg_info(Config &cfg);
+
   /** Get the full stat name.
    *
    * @param cfg Configuration instance.
@@ -77,11 +124,35 @@ protected:
   TextView _full_name;        ///< Fullname including prefix.
   int _value         = 0;     ///< Initial value.
   bool _persistent_p = false; ///< Make persistent.
+  std::unique_ptr<ts::HistogramStat> _histogram; ///< Histogram, if the stat is one.
+  std::unique_ptr<ts::ShardedStat> _sharded;     ///< Accumulator, if the stat is batched.
+  std::chrono::milliseconds _batch{0};           ///< Flush period, zero for exact updates.
+
+  /// Default smallest value of interest for a histogram.
+  static constexpr feature_type_for<INTEGER> DEFAULT_MIN = 1;
+  /// Default bits of sub-bucket for a histogram.
+  static constexpr feature_type_for<INTEGER> DEFAULT_PRECISION = 2;
+  /// Limit on the number of buckets for a histogram, as each bucket is a plugin stat.
+  static constexpr unsigned MAX_BUCKETS = 128;
+
+  /** Load the histogram configuration.
+   *
+   * @param cfg Configuration instance.
+   * @param drtv_node Directive node.
+   * @param hist_node Histogram node.
+   * @return Errors, if any.
+   */
+  Errata load_histogram(Config &cfg, YAML::Node const &drtv_node, YAML::Node hist_node);
 
   static inline const std::string NAME_TAG{"name"};
   static inline const std::string VALUE_TAG{"value"};
   static inline const std::string PERSISTENT_TAG{"persistent"};
   static inline const std::string PREFIX_TAG{"prefix"};
+  static inline const std::string BATCH_TAG{"batch"};
+  static inline const std::string HISTOGRAM_TAG{"histogram"};
+  static inline const std::string MIN_TAG{"min"};
+  static inline const std::string MAX_TAG{"max"};
+  static inline const std::string PRECISION_TAG{"precision"};
 };
 
 const HookMask Do_stat_define::HOOKS{MaskFor(Hook::POST_LOAD)};
@@ -97,22 +168,141 @@ Do_stat_define::expand_and_localize(Config &cfg, TextView const &name)
   return cfg.localize(name);
 }
 
-Errata
-Do_stat_define::cfg_init(Config &cfg, CfgStaticData const *)
+ts::ShardedStat *
+Do_stat_define::batched(Config &cfg, TextView const &name)
 {
+  if (auto cfg_info = cfg.named_object<CfgInfo>(KEY); cfg_info) {
+    if (auto spot = cfg_info->_batched.find(name); spot != cfg_info->_batched.end()) {
+      return spot->second;
+    }
+  }
+  return nullptr;
+}
+
+ts::HistogramStat *
+Do_stat_define::histogram(Config &cfg, TextView const &name)
+{
+  if (auto cfg_info = cfg.named_object<CfgInfo>(KEY); cfg_info) {
+    if (auto spot = cfg_info->_histograms.find(name); spot != cfg_info->_histograms.end()) {
+      return spot->second;
+    }
+  }
+  return nullptr;
+}
+
+auto
+Do_stat_define::cfg_info(Config &cfg) -> CfgInfo *
+{
+  if (auto cfg_info = cfg.named_object<CfgInfo>(KEY); cfg_info) {
+    return cfg_info;
+  }
   auto cfg_info = cfg.obtain_named_object<CfgInfo>(KEY);
   // Clean it up when the config is destroyed.
   cfg.mark_for_cleanup(cfg_info);
+  return cfg_info;
+}
+
+Errata
+Do_stat_define::check_update(Config &cfg, TextView const &name, YAML::Mark const &mark)
+{
+  auto cfg_info = self_type::cfg_info(cfg);
+  if (cfg_info->_names.find(name) != cfg_info->_names.end()) {
+    return {}; // already defined, resolved during load.
+  }
+  // A histogram has only the derived stats, therefore the update would never find the stat.
+  std::string count_name;
+  if (ts::plugin_stat_index(name) < 0 && ts::plugin_stat_index(swoc::bwprint(count_name, "{}.count", name)) >= 0) {
+    return Errata(S_ERROR, R"(Statistic "{}" updated at {} is a histogram defined in another configuration.)", name, mark);
+  }
+  cfg_info->_updates.emplace(cfg.localize(name), mark); // keep the first update.
+  return {};
+}
+
+Errata
+Do_stat_define::cfg_init(Config &cfg, CfgStaticData const *)
+{
+  self_type::cfg_info(cfg);
   return {};
 }
 
 Errata
 Do_stat_define::invoke(Context &)
 {
+  if (_histogram || _sharded) {
+    return {}; // the stats were created during load.
+  }
   auto &&[idx, errata]{ts::plugin_stat_define(_full_name, _value, _persistent_p)};
   return std::move(errata);
 }
 
+Errata
+Do_stat_define::load_histogram(Config &cfg, YAML::Node const &drtv_node, YAML::Node hist_node)
+{
+  if (!hist_node.IsMap()) {
+    return Errata(S_ERROR, "{} value at {} for {} directive at {} must be an object.", HISTOGRAM_TAG, hist_node.Mark(), KEY,
+                  drtv_node.Mark());
+  }
+
+  // Get the literal non-negative integer value of @a tag, or @a value if not present.
+  auto load_value = [&](std::string const &tag, feature_type_for<INTEGER> &value) -> Errata {
+    auto node = hist_node[tag];
+    if (!node) {
+      return {};
+    }
+    auto &&[expr, errata]{cfg.parse_expr(node)};
+    if (!errata.is_ok()) {
+      errata.note("While parsing {} key in {} directive at {}.", HISTOGRAM_TAG, KEY, drtv_node.Mark());
+      return std::move(errata);
+    }
+    if (expr.is_literal()) {
+      value = std::get<Expr::LITERAL>(expr._raw).as_integer(-1);
+    }
+    if (!expr.is_literal() || value < 0) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a literal non-negative integer.", tag, node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    return {};
+  };
+
+  feature_type_for<INTEGER> min = DEFAULT_MIN, max = -1, precision = DEFAULT_PRECISION;
+  if (auto errata = load_value(MIN_TAG, min); !errata.is_ok()) {
+    return std::move(errata);
+  }
+  if (auto errata = load_value(MAX_TAG, max); !errata.is_ok()) {
+    return std::move(errata);
+  }
+  if (auto errata = load_value(PRECISION_TAG, precision); !errata.is_ok()) {
+    return std::move(errata);
+  }
+  if (max < 0) {
+    return Errata(S_ERROR, "{} value at {} for {} directive at {} must have a {} key.", HISTOGRAM_TAG, hist_node.Mark(), KEY,
+                  drtv_node.Mark(), MAX_TAG);
+  }
+  if (max < min) {
+    return Errata(S_ERROR, "{} value at {} for {} directive at {} must have {} not less than {}.", HISTOGRAM_TAG, hist_node.Mark(),
+                  KEY, drtv_node.Mark(), MAX_TAG, MIN_TAG);
+  }
+  if (precision > Histogram::MAX_PRECISION) {
+    return Errata(S_ERROR, "{} value at {} for {} directive at {} must have {} no more than {}.", HISTOGRAM_TAG, hist_node.Mark(),
+                  KEY, drtv_node.Mark(), PRECISION_TAG, Histogram::MAX_PRECISION);
+  }
+  // Check the size before creating any stats.
+  if (auto n = Histogram(min, max, precision).size(); n > MAX_BUCKETS) {
+    return Errata(S_ERROR, "{} value at {} for {} directive at {} has {} buckets which is more than the limit of {}.",
+                  HISTOGRAM_TAG, hist_node.Mark(), KEY, drtv_node.Mark(), n, MAX_BUCKETS);
+  }
+
+  auto period = _batch.count() ? _batch : ts::FlushedStat::FLUSH_PERIOD;
+  auto &&[histogram, errata]{ts::HistogramStat::make(_full_name, min, max, precision, _persistent_p, period)};
+  if (!errata.is_ok()) {
+    errata.note("While creating stats for {} directive at {}.", KEY, drtv_node.Mark());
+    return std::move(errata);
+  }
+  _histogram = std::move(histogram);
+  cfg.named_object<CfgInfo>(KEY)->_histograms.insert({_name, _histogram.get()});
+  return {};
+}
+
 Rv<Directive::Handle>
 Do_stat_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
                      YAML::Node key_value)
@@ -204,16 +394,69 @@ Do_stat_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
     drtv_node.remove(persistent_node); // ugly, need to fix the overall API.
     self->_persistent_p = std::get<IndexFor(BOOLEAN)>(std::get<Expr::LITERAL>(persistent_expr._raw));
   }
+
+  if (auto batch_node = key_value[BATCH_TAG]; batch_node) {
+    auto &&[batch_expr, batch_errata]{cfg.parse_expr(batch_node)};
+    if (!batch_errata.is_ok()) {
+      batch_errata.note("While parsing {} directive at {}.", KEY, drtv_node.Mark());
+      return std::move(batch_errata);
+    }
+    if (!batch_expr.is_literal()) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a literal duration.", BATCH_TAG, batch_node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    auto &&[batch, errata]{std::get<Expr::LITERAL>(batch_expr._raw).as_duration()};
+    self->_batch = std::chrono::duration_cast<std::chrono::milliseconds>(batch);
+    if (!errata.is_ok() || self->_batch.count() <= 0) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a positive duration.", BATCH_TAG, batch_node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    drtv_node.remove(batch_node);
+  }
+
+  // These are resolved when an update is loaded, so an earlier update would not use them.
+  if (key_value[HISTOGRAM_TAG] || self->_batch.count()) {
+    auto &updates = cfg.named_object<CfgInfo>(KEY)->_updates;
+    for (auto n : {self->_name, self->_full_name}) {
+      if (auto spot = updates.find(n); spot != updates.end()) {
+        return Errata(S_ERROR, R"({} directive at {} for "{}" must be before the update of the statistic at {}.)", KEY,
+                      drtv_node.Mark(), self->_name, spot->second);
+      }
+    }
+  }
+
+  if (auto hist_node = key_value[HISTOGRAM_TAG]; hist_node) {
+    if (value_node) {
+      return Errata(S_ERROR, "{} directive at {} can not have both {} and {} keys.", KEY, drtv_node.Mark(), VALUE_TAG,
+                    HISTOGRAM_TAG);
+    }
+    if (auto errata = self->load_histogram(cfg, drtv_node, hist_node); !errata.is_ok()) {
+      return std::move(errata);
+    }
+    drtv_node.remove(hist_node);
+  } else if (self->_batch.count()) {
+    auto &&[sharded, errata]{ts::ShardedStat::make(self->_full_name, self->_batch, self->_value, self->_persistent_p)};
+    if (!errata.is_ok()) {
+      errata.note("While creating stat for {} directive at {}.", KEY, drtv_node.Mark());
+      return std::move(errata);
+    }
+    self->_sharded = std::move(sharded);
+    cfg.named_object<CfgInfo>(KEY)->_batched.insert({self->_name, self->_sharded.get()});
+  }
   return handle;
 }
 /* ------------------------------------------------------------------------------------ */
 /// Statistic information.
 /// The name is used when it can't be resolved during configuration loading.
+/// For a histogram the value is the count of recorded values and updating records a value.
+/// For a batched stat updates are accumulated per thread and added to the stat periodically.
 struct Stat {
   static constexpr int UNRESOLVED = -1;
   static constexpr int INVALID    = -2;
   TextView _name;        ///< Statistic name.
   int _idx = UNRESOLVED; ///< Statistic index.
+  ts::HistogramStat *_histogram = nullptr; ///< Histogram, if the stat is one.
+  ts::ShardedStat *_batch       = nullptr; ///< Accumulator, if the stat is batched.
 
   Stat(Config &cfg, TextView const &name) { this->assign(cfg, name); }
 
@@ -221,6 +464,14 @@ struct Stat {
   assign(Config &cfg, TextView name)
   {
     _name = Do_stat_define::expand_and_localize(cfg, name);
+    if ((_histogram = Do_stat_define::histogram(cfg, name)) != nullptr) {
+      _idx = _histogram->count_index();
+      return *this;
+    }
+    if ((_batch = Do_stat_define::batched(cfg, name)) != nullptr) {
+      _idx = _batch->index();
+      return *this;
+    }
 
     _idx = ts::plugin_stat_index(_name);
     _idx = _idx < 0 ? UNRESOLVED : _idx; // normalize.
@@ -249,6 +500,14 @@ struct Stat {
   Stat &
   update(feature_type_for<INTEGER> value)
   {
+    if (_histogram) {
+      _histogram->record(value < 0 ? 0 : value);
+      return *this;
+    }
+    if (_batch) {
+      _batch->increment(value);
+      return *this;
+    }
     auto n{this->index()};
     if (n >= 0) {
       ts::plugin_stat_update(n, value);
@@ -296,8 +555,12 @@ Do_stat_update::Do_stat_update(Config &cfg, TextView const &name, Expr &&expr) :
 Errata
 Do_stat_update::invoke(Context &ctx)
 {
-  auto [value, errata]{ctx.extract(_expr).as_integer(0)};
-  if (value != 0) {
+  auto feature{ctx.extract(_expr)};
+  if (_stat._histogram && is_nil(feature)) {
+    return {}; // no value to record.
+  }
+  auto [value, errata]{feature.as_integer(0)};
+  if (value != 0 || _stat._histogram) { // zero is a valid value for a histogram.
     _stat.update(value);
   }
   return std::move(errata);
@@ -307,6 +570,11 @@ Rv<Directive::Handle>
 Do_stat_update::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &arg,
                      YAML::Node key_value)
 {
+  if (auto errata = Do_stat_define::check_update(cfg, arg, drtv_node.Mark()); !errata.is_ok()) {
+    errata.note("While parsing {} directive at {}.", KEY, drtv_node.Mark());
+    return std::move(errata);
+  }
+
   if (key_value.IsNull()) {
     return Handle(new self_type(cfg, arg, Expr{feature_type_for<INTEGER>(1)}));
   }
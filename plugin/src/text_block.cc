@@ -5,11 +5,31 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
-#include <shared_mutex>
+#include <bitset>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Compression libraries are optional, the build defines these if they are available.
+#if !defined(TXN_BOX_ZLIB)
+#define TXN_BOX_ZLIB 0
+#endif
+#if !defined(TXN_BOX_BROTLI)
+#define TXN_BOX_BROTLI 0
+#endif
+
+#if TXN_BOX_ZLIB
+#include <zlib.h>
+#endif
+#if TXN_BOX_BROTLI
+#include <brotli/encode.h>
+#endif
 
 #include "txn_box/common.h"
 
 #include <swoc/TextView.h>
+#include <swoc/Lexicon.h>
 #include <swoc/Errata.h>
 #include <swoc/ArenaWriter.h>
 #include <swoc/BufferWriter.h>
@@ -22,6 +42,7 @@
 #include "txn_box/Comparison.h"
 #include "txn_box/Config.h"
 #include "txn_box/Context.h"
+#include "txn_box/Epoch.h"
 
 #include "txn_box/yaml_util.h"
 #include "txn_box/ts_util.h"
@@ -38,9 +59,12 @@ using Clock = std::chrono::system_clock;
 
 /** Define a static text block.
  *
- * The content is stored in s shared pointer to a @c std::string.
+ * The content is stored in a @c std::string, or mapped from the file, along with any compressed variants. It is owned by a
+ * shared pointer and published to readers as a plain pointer. The compressed variants are built when the content is loaded.
  *
- * The shared pointer is used so the content can be persisted during a transaction even if there is a reload of that content.
+ * When the content is reloaded the previous content is retired to the configuration level @c Epoch so that it persists until
+ * every reader that might have loaded the pointer is done. A transaction is in the epoch only while it takes a reference to
+ * the content, and keeps that reference until it is done, so it holds only the content it used rather than every reload.
  *
  * @c std::string is used because reloads make the content lifetime asynchronous with both configuration and transactions, making
  * those arenas not appropriate.
@@ -64,6 +88,25 @@ public:
     void operator()(); ///< Do the update check.
   };
 
+  /// Content encodings that can be pre-computed.
+  enum Encoding : uint8_t { GZIP, BROTLI, N_ENCODINGS };
+  /// Names of encodings, as used in HTTP fields.
+  static const swoc::Lexicon<Encoding> EncodingNames;
+
+  /// Block content.
+  struct Content : public std::enable_shared_from_this<Content> {
+    TextView _text;            ///< Unencoded content.
+    std::string _data;         ///< Storage for @a _text if not mapped.
+    swoc::MemSpan<void> _map;  ///< Mapped file, if any.
+    /// Encoded variants of @a _text, empty if not available.
+    std::array<std::string, N_ENCODINGS> _encoded;
+
+    Content() = default;
+    Content(Content const &) = delete; // @a _text may refer to @a _data.
+    Content &operator=(Content const &) = delete;
+    ~Content();
+  };
+
   ~Do_text_block_define() noexcept;
 
   Errata invoke(Context &ctx) override; ///< Runtime activation.
@@ -97,6 +140,7 @@ protected:
   /// Config level data for all text blocks.
   struct CfgInfo {
     MapHandle _map; ///< Map of names to specific text block definitions.
+    Epoch _epoch;   ///< Reclamation of reloaded content.
 
     explicit CfgInfo(MapHandle && map) : _map(std::move(map)) {}
   };
@@ -107,10 +151,15 @@ protected:
   feature_type_for<DURATION> _duration;                                       ///< Time between update checks.
   std::atomic<Clock::duration> _last_check = Clock::now().time_since_epoch(); ///< Absolute time of the last alert.
   Clock::time_point _last_modified;                                           ///< Last modified time of the file.
-  std::shared_ptr<std::string> _content;                                      ///< Content of the file.
+  std::shared_ptr<Content> _content_handle;                                   ///< Content of the file, owning.
+  std::atomic<Content const *> _content{nullptr};                             ///< Content of the file, for readers.
+  std::shared_ptr<Content> _text_content;                                     ///< Content from the literal text.
+  std::bitset<N_ENCODINGS> _encodings;                                        ///< Encoded variants to build.
+  bool _mmap_p = false;                                                       ///< Map the file rather than read it.
   int _line_no = 0;                                                           ///< For debugging name conflicts.
-  std::shared_mutex _content_mutex;                                           ///< Lock for access @a content.
   ts::TaskHandle _task;                                                       ///< Handle for periodic checking task.
+  unsigned _watch_id = 0;                                                     ///< File watch identifier, 0 if none.
+  std::mutex _update_mutex;                                                   ///< Serialize updates.
 
   FeatureGroup _fg; ///< Support cross reference in the keys.
   using index_type                  = FeatureGroup::index_type;
@@ -122,6 +171,8 @@ protected:
   static inline const std::string TEXT_TAG{"text"};
   static inline const std::string DURATION_TAG{"duration"};
   static inline const std::string NOTIFY_TAG{"notify"};
+  static inline const std::string COMPRESS_TAG{"compress"};
+  static inline const std::string MMAP_TAG{"mmap"};
 
   /// Map of names to text blocks.
   static Map *map(Config & cfg);
@@ -129,24 +180,203 @@ protected:
   /// Get the "update" time for a file - the max of modified and changed times.
   static Clock::time_point update_time(swoc::file::file_status const& stat);
 
+  /** Replace the content.
+   *
+   * @param epoch Epoch for retiring the current content.
+   * @param content New content, may be @c nullptr.
+   */
+  void publish(Epoch &epoch, std::shared_ptr<Content> content);
+
+  /** Make content from @a text.
+   *
+   * @param text Unencoded content.
+   * @return The content, with the configured encoded variants.
+   */
+  std::shared_ptr<Content> make_content(std::string &&text) const;
+
+  /** Load content from the file.
+   *
+   * @param ec [out] Error code for loading the file.
+   * @return The content, with the configured encoded variants, or @c nullptr on failure.
+   *
+   * If @a _mmap_p is set the file is mapped, otherwise it is read.
+   */
+  std::shared_ptr<Content> load_content(std::error_code &ec) const;
+
+  /** Finish loading @a content.
+   *
+   * Build the configured encoded variants and publish the content and variants as shared bodies.
+   */
+  void complete_content(Content &content) const;
+
+  /** Encode @a text.
+   *
+   * @param encoding Encoding to use.
+   * @param text Text to encode.
+   * @return The encoded text, or an empty string if it could not be encoded or is not smaller.
+   */
+  static std::string encode(Encoding encoding, TextView text);
+
+  /// @return The current content, or @c nullptr if there is none.
+  Content const *
+  content() const
+  {
+    auto content = _content.load();
+    return content ? content : _text_content.get();
+  }
+
   /// Default constructor - only available to friends.
   Do_text_block_define() = default;
 
   friend class Ex_text_block;
+  friend class Ex_text_block_encoded;
+  friend class Ex_text_block_encoding;
   friend class Mod_as_text_block;
   friend Updater;
 };
 
 const HookMask Do_text_block_define::HOOKS{MaskFor(Hook::POST_LOAD)};
 
+const swoc::Lexicon<Do_text_block_define::Encoding> Do_text_block_define::EncodingNames{
+  {{GZIP, "gzip"}, {BROTLI, "br"}}, N_ENCODINGS
+};
+
 inline Clock::time_point
 Do_text_block_define::update_time(swoc::file::file_status const &stat)
 {
   return std::max(swoc::file::last_write_time(stat), swoc::file::status_time(stat));
 }
 
+std::string
+Do_text_block_define::encode(Encoding encoding, TextView text)
+{
+  std::string zret;
+  switch (encoding) {
+#if TXN_BOX_ZLIB
+  case GZIP: {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // Window bits of 15 + 16 selects the gzip format rather than zlib.
+    if (Z_OK != deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY)) {
+      break;
+    }
+    zret.resize(deflateBound(&zs, text.size()));
+    zs.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+    zs.avail_in  = text.size();
+    zs.next_out  = reinterpret_cast<Bytef *>(zret.data());
+    zs.avail_out = zret.size();
+    if (Z_STREAM_END == deflate(&zs, Z_FINISH)) {
+      zret.resize(zs.total_out);
+    } else {
+      zret.clear();
+    }
+    deflateEnd(&zs);
+  } break;
+#endif
+#if TXN_BOX_BROTLI
+  case BROTLI: {
+    size_t n = BrotliEncoderMaxCompressedSize(text.size());
+    zret.resize(n);
+    if (n && BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, text.size(),
+                                   reinterpret_cast<uint8_t const *>(text.data()), &n, reinterpret_cast<uint8_t *>(zret.data()))) {
+      zret.resize(n);
+    } else {
+      zret.clear();
+    }
+  } break;
+#endif
+  default:
+    break;
+  }
+  if (zret.size() >= text.size()) { // no point in using it.
+    zret.clear();
+  }
+  return zret;
+}
+
+Do_text_block_define::Content::~Content()
+{
+  auto &shared = ts::SharedBody::instance();
+  shared.withdraw(_text);
+  for (auto const &text : _encoded) {
+    shared.withdraw(text);
+  }
+  if (_map.data()) {
+    munmap(_map.data(), _map.size());
+  }
+}
+
+void
+Do_text_block_define::complete_content(Content &content) const
+{
+  auto &shared = ts::SharedBody::instance();
+  shared.publish(content._text);
+  for (unsigned idx = 0; idx < N_ENCODINGS; ++idx) {
+    if (_encodings[idx]) {
+      content._encoded[idx] = self_type::encode(Encoding(idx), content._text);
+      shared.publish(content._encoded[idx]);
+    }
+  }
+}
+
+auto
+Do_text_block_define::make_content(std::string &&text) const -> std::shared_ptr<Content>
+{
+  auto content   = std::make_shared<Content>();
+  content->_data = std::move(text);
+  content->_text = content->_data;
+  this->complete_content(*content);
+  return content;
+}
+
+auto
+Do_text_block_define::load_content(std::error_code &ec) const -> std::shared_ptr<Content>
+{
+  ec.clear();
+  if (!_mmap_p) {
+    auto text = swoc::file::load(_path, ec);
+    return ec ? nullptr : this->make_content(std::move(text));
+  }
+
+  int fd = ::open(_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    ec = std::error_code(errno, std::system_category());
+    return nullptr;
+  }
+  auto content = std::make_shared<Content>();
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    ec = std::error_code(errno, std::system_category());
+  } else if (st.st_size > 0) { // can't map an empty file, leave the content empty.
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      ec = std::error_code(errno, std::system_category());
+    } else {
+      content->_map  = swoc::MemSpan<void>{addr, size_t(st.st_size)};
+      content->_text = TextView{static_cast<char const *>(addr), size_t(st.st_size)};
+    }
+  }
+  ::close(fd);
+  if (ec) {
+    return nullptr;
+  }
+  this->complete_content(*content);
+  return content;
+}
+
+void
+Do_text_block_define::publish(Epoch &epoch, std::shared_ptr<Content> content)
+{
+  _content.store(content.get());
+  std::swap(_content_handle, content);
+  epoch.retire(std::move(content)); // previous content.
+}
+
 Do_text_block_define::~Do_text_block_define() noexcept
 {
+  if (_watch_id) {
+    ts::FileWatch::instance().unwatch(_watch_id);
+  }
   _task.cancel();
 }
 
@@ -160,10 +390,14 @@ Do_text_block_define::map(Config & cfg) -> Map *
 Errata
 Do_text_block_define::invoke(Context &ctx)
 {
-  // Set up the update checking.
+  // Set up the update checking. Changes are detected by the file watch, the periodic check is
+  // a fallback in case a change is missed.
   if (_duration.count()) {
     _task =
       ts::PerformAsTaskEvery(Updater{ctx.acquire_cfg(), this}, std::chrono::duration_cast<std::chrono::milliseconds>(_duration));
+    if (!_path.empty()) {
+      _watch_id = ts::FileWatch::instance().watch(_path, Updater{ctx.acquire_cfg(), this});
+    }
   }
   return {};
 }
@@ -228,11 +462,62 @@ Do_text_block_define::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_n
 
   self->_notify_idx = fg.index_of(NOTIFY_TAG);
 
+  if (auto compress_node = key_value[COMPRESS_TAG]; compress_node) {
+    if (!compress_node.IsScalar() && !compress_node.IsSequence()) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be an encoding name or a list of them.", COMPRESS_TAG,
+                    compress_node.Mark(), KEY, drtv_node.Mark());
+    }
+    auto define_encoding = [&](YAML::Node const &node) -> Errata {
+      auto name = node.IsScalar() ? TextView{node.Scalar()} : TextView{};
+      auto idx  = EncodingNames[name];
+      if (idx == N_ENCODINGS) {
+        return Errata(S_ERROR, R"("{}" at {} for {} directive at {} is not a supported encoding.)", name, node.Mark(), KEY,
+                      drtv_node.Mark());
+      }
+      if ((idx == GZIP && !TXN_BOX_ZLIB) || (idx == BROTLI && !TXN_BOX_BROTLI)) {
+        return Errata(S_ERROR, R"(Encoding "{}" at {} for {} directive at {} is not available in this build.)", name, node.Mark(),
+                      KEY, drtv_node.Mark());
+      }
+      self->_encodings[idx] = true;
+      return {};
+    };
+    if (compress_node.IsScalar()) {
+      errata = define_encoding(compress_node);
+    } else {
+      for (auto const &child : compress_node) {
+        if (errata = define_encoding(child); !errata.is_ok()) {
+          break;
+        }
+      }
+    }
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+  }
+
+  if (auto mmap_node = key_value[MMAP_TAG]; mmap_node) {
+    auto &&[mmap_expr, mmap_errata] = cfg.parse_expr(mmap_node);
+    if (!mmap_errata.is_ok()) {
+      mmap_errata.note("While parsing {} directive at {}.", KEY, drtv_node.Mark());
+      return std::move(mmap_errata);
+    }
+    if (!mmap_expr.is_literal()) {
+      return Errata(S_ERROR, "{} value at {} for {} directive at {} must be a literal boolean.", MMAP_TAG, mmap_node.Mark(), KEY,
+                    drtv_node.Mark());
+    }
+    self->_mmap_p = std::get<Expr::LITERAL>(mmap_expr._raw).as_bool();
+  }
+
+  if (self->_text.has_value()) {
+    self->_text_content = self->make_content(std::string{self->_text.value()});
+  }
+
   if (!self->_path.empty()) {
     std::error_code ec;
-    auto content = swoc::file::load(self->_path, ec);
+    auto content = self->load_content(ec);
     if (!ec) {
-      self->_content = std::make_shared<std::string>(std::move(content));
+      self->_content_handle = std::move(content);
+      self->_content        = self->_content_handle.get();
     } else if (self->_text.has_value()) {
       self->_content = nullptr;
     } else {
@@ -269,6 +554,11 @@ Do_text_block_define::Updater::operator()()
     return; // presume the config destruction is ongoing and will clean this up.
   }
 
+  // The file watch and the periodic check can run at the same time.
+  std::lock_guard update_lock(_block->_update_mutex);
+  auto &epoch = cfg->named_object<CfgInfo>(KEY)->_epoch;
+  epoch.reclaim(); // Clean up content no longer used by transactions.
+
   // This should be scheduled at the appropriate intervals and so no need to check time.
   std::error_code ec;
   auto fs = swoc::file::status(_block->_path, ec);
@@ -277,14 +567,10 @@ Do_text_block_define::Updater::operator()()
     if (mtime <= _block->_last_modified) {
       return; // same as it ever was...
     }
-    auto content = std::make_shared<std::string>();
-    *content     = swoc::file::load(_block->_path, ec);
+    auto content = _block->load_content(ec);
     if (!ec) { // swap in updated content.
-      {
-        std::unique_lock lock(_block->_content_mutex);
-        _block->_content       = content;
-        _block->_last_modified = mtime;
-      }
+      _block->publish(epoch, std::move(content));
+      _block->_last_modified = mtime;
       if (_block->_notify_idx != FeatureGroup::INVALID_IDX) {
         Context ctx(cfg);
         auto text{_block->_fg.extract(ctx, _block->_notify_idx)};
@@ -297,8 +583,9 @@ Do_text_block_define::Updater::operator()()
   // If control flow gets here, the file is no longer accessible and the content
   // should be cleared. If the file shows up again, it should have a modified time
   // later than the previously existing file, so that can be left unchanged.
-  std::unique_lock lock(_block->_content_mutex);
-  _block->_content.reset();
+  if (_block->_content_handle) {
+    _block->publish(epoch, nullptr);
+  }
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -325,6 +612,46 @@ protected:
    */
   static Feature extract_block(Context & ctx, TextView tag);
 
+  /// Content selected for a block by a transaction.
+  struct Selection {
+    Do_text_block_define const *_block                       = nullptr;                           ///< Block.
+    std::shared_ptr<Do_text_block_define::Content const> _content;                                ///< Content, loaded once.
+    Do_text_block_define::Encoding _encoding                 = Do_text_block_define::N_ENCODINGS; ///< Selected encoding.
+    bool _encoding_p                                         = false;                             ///< @a _encoding has been selected.
+    Selection *_next                                         = nullptr;                           ///< Next selection for the transaction.
+  };
+
+  /// Context data for text blocks.
+  struct CtxInfo {
+    Selection *_selections = nullptr; ///< Blocks used by the transaction.
+  };
+  /// Name of the context data.
+  static constexpr TextView CTX_KEY{"text-block-selection"};
+
+  /** Select the content of the block for @a tag.
+   *
+   * @param ctx Transaction context.
+   * @param tag Block tag.
+   * @param encoding_p Also select the encoding.
+   * @return The selection, or @c nullptr if there is no such block or it has no content.
+   *
+   * The content is loaded and the encoding selected only on the first call for @a tag in @a ctx, so that every
+   * extractor in the transaction sees the same variant even if the block is reloaded in between. The content is
+   * kept until @a ctx is destroyed and so views of it are transaction persistent.
+   */
+  static Selection const * select(Context & ctx, TextView tag, bool encoding_p = false);
+
+  /** Select the encoding for @a content.
+   *
+   * @param ctx Transaction context.
+   * @param content Block content.
+   * @return The encoding, or @c N_ENCODINGS for unencoded content.
+   *
+   * The encoding is selected by the "Accept-Encoding" field in the user agent request, from the variants available in
+   * @a content. The largest weight is preferred, and for equal weights brotli is preferred over gzip.
+   */
+  static Do_text_block_define::Encoding select_encoding(Context & ctx, Do_text_block_define::Content const & content);
+
   friend class Mod_as_text_block; // Access to @c extract_block.
 };
 
@@ -340,32 +667,112 @@ Ex_text_block::validate(Config &cfg, Spec &spec, const TextView &arg)
   return {STRING};
 }
 
-Feature Ex_text_block::extract_block(Context& ctx, TextView tag)
+auto
+Ex_text_block::select(Context &ctx, TextView tag, bool encoding_p) -> Selection const *
 {
-  if (auto info = ctx.cfg().named_object<Do_text_block_define::CfgInfo>(Do_text_block_define::KEY) ; info) {
-    if (auto spot = info->_map->find(tag); spot != info->_map->end()) {
-      auto block = spot->second;
-      std::shared_ptr<std::string> content;
-      { // grab a copy of the shared pointer to file content.
-        std::shared_lock lock(block->_content_mutex);
-        content = block->_content;
+  auto info = ctx.cfg().named_object<Do_text_block_define::CfgInfo>(Do_text_block_define::KEY);
+  if (nullptr == info) {
+    return nullptr;
+  }
+  auto spot = info->_map->find(tag);
+  if (spot == info->_map->end()) {
+    return nullptr;
+  }
+  auto block     = spot->second;
+  auto ctx_info  = ctx.obtain_named_object<CtxInfo>(CTX_KEY);
+  Selection *sel = ctx_info->_selections;
+  while (sel && sel->_block != block) {
+    sel = sel->_next;
+  }
+  if (nullptr == sel) {
+    std::shared_ptr<Do_text_block_define::Content const> content;
+    { // The epoch is needed only to take a reference, which then keeps the content.
+      auto guard = info->_epoch.enter();
+      // File content if available, otherwise the alternate text.
+      if (auto ptr = block->content(); ptr) {
+        content = ptr->shared_from_this();
       }
+    }
+    if (!content) {
+      return nullptr;
+    }
+    sel                   = ctx.make<Selection>();
+    sel->_block           = block;
+    sel->_content         = std::move(content);
+    sel->_next            = ctx_info->_selections;
+    ctx_info->_selections = sel;
+    ctx.mark_for_cleanup(sel); // release the content when the txn is done.
+  }
+  if (encoding_p && !sel->_encoding_p) {
+    sel->_encoding   = select_encoding(ctx, *sel->_content);
+    sel->_encoding_p = true;
+  }
+  return sel;
+}
 
-      if (content) {
-        // If there is content, it must persist the content until end of the directive. There's no direct support for that so the
-        // best that can be done is to persist until the end of the transaction by putting it in context storage.
-        auto * ptr = ctx.make<std::shared_ptr<std::string>>(content); // make a copy in context storage.
-        ctx.mark_for_cleanup(ptr); // clean it up when the txn is done.
-        return FeatureView(*content);
-      }
+Feature Ex_text_block::extract_block(Context& ctx, TextView tag)
+{
+  if (auto sel = select(ctx, tag); sel) {
+    return FeatureView(sel->_content->_text);
+  }
+  return NIL_FEATURE;
+}
 
-      // No file content, see if there's alternate text.
-      if (block->_text.has_value()) {
-        return FeatureView{block->_text.value()};
+Do_text_block_define::Encoding
+Ex_text_block::select_encoding(Context &ctx, Do_text_block_define::Content const &content)
+{
+  using Block                               = Do_text_block_define;
+  static constexpr TextView ACCEPT_ENCODING = "Accept-Encoding";
+  static constexpr int Q_UNSET              = -1;
+  auto zret                                 = Block::N_ENCODINGS;
+
+  std::array<int, Block::N_ENCODINGS> q;
+  q.fill(Q_UNSET);
+  int q_any = Q_UNSET; // Weight for "*".
+
+  if (auto hdr{ctx.ua_req_hdr()}; hdr.is_valid()) {
+    for (auto field{hdr.field(ACCEPT_ENCODING)}; field.is_valid(); field = field.next_dup()) {
+      TextView value = field.value();
+      while (value) {
+        auto params = value.take_prefix_at(',');
+        auto coding = params.take_prefix_at(';').trim_if(&isspace);
+        int weight  = 1000; // in thousandths.
+        while (params) {
+          auto param = params.take_prefix_at(';').trim_if(&isspace);
+          if (auto key = param.take_prefix_at('=').trim_if(&isspace); key.size() == 1 && (key[0] == 'q' || key[0] == 'Q')) {
+            param.trim_if(&isspace);
+            auto whole = param.take_prefix_at('.');
+            weight     = swoc::svtou(whole) * 1000;
+            for (int scale = 100; scale > 0; scale /= 10) {
+              weight += (param && isdigit(param[0]) ? param[0] - '0' : 0) * scale;
+              param.remove_prefix(1);
+            }
+            weight = std::min(weight, 1000);
+          }
+        }
+        if (coding == "*") {
+          q_any = weight;
+        } else if (0 == strcasecmp(coding, "x-gzip"_tv)) {
+          q[Block::GZIP] = weight;
+        } else if (auto idx = Block::EncodingNames[coding]; idx != Block::N_ENCODINGS) {
+          q[idx] = weight;
+        }
       }
     }
   }
-  return NIL_FEATURE;
+
+  int best = 0; // Must be better than this, weight 0 means not acceptable.
+  for (auto idx : {Block::BROTLI, Block::GZIP}) {
+    if (content._encoded[idx].empty()) {
+      continue;
+    }
+    auto weight = q[idx] == Q_UNSET ? q_any : q[idx];
+    if (weight > best) {
+      best = weight;
+      zret = idx;
+    }
+  }
+  return zret;
 }
 
 Feature
@@ -467,15 +874,76 @@ Mod_as_text_block::operator()(Context &ctx, Feature &feature)
   return { zret };
 }
 
+/* ------------------------------------------------------------------------------------ */
+/// Text block content, encoded as selected by the user agent request.
+class Ex_text_block_encoded : public Ex_text_block
+{
+  using self_type  = Ex_text_block_encoded; ///< Self reference type.
+  using super_type = Ex_text_block;         ///< Parent type.
+public:
+  static constexpr TextView NAME{"text-block-encoded"};
+
+  Feature extract(Context &ctx, Spec const &spec) override;
+};
+
+Feature
+Ex_text_block_encoded::extract(Context &ctx, const Spec &spec)
+{
+  auto arg = spec._data.span.rebind<TextView>()[0];
+  if (auto sel = select(ctx, arg, true); sel) {
+    if (sel->_encoding != Do_text_block_define::N_ENCODINGS) {
+      return FeatureView(sel->_content->_encoded[sel->_encoding]);
+    }
+    return FeatureView(sel->_content->_text);
+  }
+  return NIL_FEATURE;
+}
+
+/// Name of the encoding for @c Ex_text_block_encoded.
+class Ex_text_block_encoding : public Ex_text_block
+{
+  using self_type  = Ex_text_block_encoding; ///< Self reference type.
+  using super_type = Ex_text_block;          ///< Parent type.
+public:
+  static constexpr TextView NAME{"text-block-encoding"};
+
+  Rv<ActiveType> validate(Config &cfg, Spec &spec, TextView const &arg) override;
+  Feature extract(Context &ctx, Spec const &spec) override;
+};
+
+Rv<ActiveType>
+Ex_text_block_encoding::validate(Config &cfg, Spec &spec, const TextView &arg)
+{
+  auto &&[type, errata] = super_type::validate(cfg, spec, arg);
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+  return ActiveType{NIL, STRING};
+}
+
+Feature
+Ex_text_block_encoding::extract(Context &ctx, const Spec &spec)
+{
+  auto arg = spec._data.span.rebind<TextView>()[0];
+  if (auto sel = select(ctx, arg, true); sel && sel->_encoding != Do_text_block_define::N_ENCODINGS) {
+    return FeatureView::Literal(Do_text_block_define::EncodingNames[sel->_encoding]);
+  }
+  return NIL_FEATURE;
+}
+
 /* ------------------------------------------------------------------------------------ */
 
 namespace
 {
 Ex_text_block text_block;
+Ex_text_block_encoded text_block_encoded;
+Ex_text_block_encoding text_block_encoding;
 
 [[maybe_unused]] bool INITIALIZED = []() -> bool {
   Config::define<Do_text_block_define>();
   Extractor::define(Ex_text_block::NAME, &text_block);
+  Extractor::define(Ex_text_block_encoded::NAME, &text_block_encoded);
+  Extractor::define(Ex_text_block_encoding::NAME, &text_block_encoding);
   Modifier::define<Mod_as_text_block>();
   return true;
 }();
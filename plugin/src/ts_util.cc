@@ -9,6 +9,17 @@
 #include <map>
 #include <numeric>
 #include <alloca.h>
+#include <algorithm>
+#include <thread>
+
+#if __has_include(<sys/inotify.h>)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#define TXN_BOX_INOTIFY 1
+#else
+#define TXN_BOX_INOTIFY 0
+#endif
 
 #include <openssl/ssl.h>
 
@@ -30,7 +41,7 @@ using swoc::MemSpan;
 namespace bwf = swoc::bwf;
 using namespace swoc::literals;
 
-#if TS_VERSION_MAJOR >= 10
+#if TS_VERSION_MAJOR >= 10 && !defined(TXN_BOX_STANDALONE)
 
 DbgCtl txn_box_dbg_ctl{DEBUG_TAG};
 
@@ -1056,6 +1067,318 @@ PerformAsTaskEvery(std::function<void()> &&task, std::chrono::milliseconds perio
   return {TSContScheduleEveryOnPool(contp, period.count(), TS_THREAD_POOL_TASK), contp};
 }
 /* ------------------------------------------------------------------------ */
+FileWatch::FileWatch()
+{
+#if TXN_BOX_INOTIFY
+  _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_fd < 0) {
+    DebugMsg("inotify not available [{}], file changes will be polled.", swoc::bwf::Errno{});
+  }
+#endif
+}
+
+FileWatch &
+FileWatch::instance()
+{
+  static self_type *instance = new self_type; // never destroyed, the thread may be running at exit.
+  return *instance;
+}
+
+unsigned
+FileWatch::watch(swoc::file::path const &path, Callback &&f)
+{
+  std::lock_guard lock(_mutex);
+  auto &item = _items.emplace_back();
+  item._id   = _next_id++;
+  item._path = path;
+  item._name = path.view().substr(path.view().rfind('/') + 1); // whole path if not found.
+  item._f    = std::move(f);
+  std::error_code ec;
+  item._mtime = swoc::file::last_write_time(swoc::file::status(path, ec));
+#if TXN_BOX_INOTIFY
+  if (_fd >= 0) {
+    auto dir = path.parent_path();
+    item._wd = inotify_add_watch(_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ATTRIB);
+    if (item._wd < 0) {
+      DebugMsg("Failed to watch {} [{}], it will be polled.", dir, swoc::bwf::Errno{});
+    }
+  }
+#endif
+  if (!_running_p) {
+    _running_p = true;
+    std::thread([this]() { this->run(); }).detach();
+  }
+  return item._id;
+}
+
+void
+FileWatch::unwatch(unsigned id)
+{
+  std::lock_guard lock(_mutex);
+  auto spot = std::find_if(_items.begin(), _items.end(), [=](Item const &item) { return item._id == id; });
+  if (spot == _items.end()) {
+    return;
+  }
+#if TXN_BOX_INOTIFY
+  // The watch is per directory - remove it only if no other file is using it.
+  if (auto wd = spot->_wd; wd >= 0 &&
+                           std::none_of(_items.begin(), _items.end(), [&](Item const &item) { return &item != &*spot && item._wd == wd; })) {
+    inotify_rm_watch(_fd, wd);
+  }
+#endif
+  _items.erase(spot);
+}
+
+void
+FileWatch::run()
+{
+  auto next_poll = std::chrono::system_clock::now() + POLL_PERIOD;
+  while (true) {
+#if TXN_BOX_INOTIFY
+    if (_fd >= 0) {
+      pollfd pfd{_fd, POLLIN, 0};
+      if (::poll(&pfd, 1, std::chrono::milliseconds(POLL_PERIOD).count()) > 0) {
+        this->process_events();
+      }
+    } else {
+      std::this_thread::sleep_for(POLL_PERIOD);
+    }
+#else
+    std::this_thread::sleep_for(POLL_PERIOD);
+#endif
+    // Files that could not be watched are always polled.
+    if (auto now = std::chrono::system_clock::now(); now >= next_poll) {
+      this->poll_files();
+      next_poll = now + POLL_PERIOD;
+    }
+  }
+}
+
+void
+FileWatch::process_events()
+{
+#if TXN_BOX_INOTIFY
+  alignas(inotify_event) char buff[4096];
+  ssize_t n;
+  while ((n = ::read(_fd, buff, sizeof(buff))) > 0) {
+    std::lock_guard lock(_mutex);
+    for (char *spot = buff; spot < buff + n;) {
+      auto event = reinterpret_cast<inotify_event *>(spot);
+      spot += sizeof(inotify_event) + event->len;
+      if (event->len == 0) {
+        continue;
+      }
+      TextView name{event->name, strlen(event->name)};
+      for (auto &item : _items) {
+        if (item._wd == event->wd && name == item._name) {
+          PerformAsTask(Callback(item._f));
+        }
+      }
+    }
+  }
+#endif
+}
+
+void
+FileWatch::poll_files()
+{
+  std::lock_guard lock(_mutex);
+  for (auto &item : _items) {
+    if (item._wd >= 0) {
+      continue; // watched by inotify.
+    }
+    std::error_code ec;
+    auto mtime = swoc::file::last_write_time(swoc::file::status(item._path, ec));
+    if (mtime != item._mtime) {
+      item._mtime = mtime;
+      PerformAsTask(Callback(item._f));
+    }
+  }
+}
+/* ------------------------------------------------------------------------ */
+SharedBody &
+SharedBody::instance()
+{
+  static self_type *instance = new self_type; // never destroyed, transactions may be active at exit.
+  return *instance;
+}
+
+SharedBody::Item::~Item()
+{
+  if (_buff) {
+    TSIOBufferDestroy(_buff);
+  }
+}
+
+void
+SharedBody::publish(TextView view)
+{
+  if (view.empty()) {
+    return;
+  }
+  std::unique_lock lock(_mutex);
+  _items.acquire(view);
+}
+
+void
+SharedBody::withdraw(TextView view)
+{
+  if (view.empty()) {
+    return;
+  }
+  std::unique_ptr<Item> item; // destroy outside the lock.
+  std::unique_lock lock(_mutex);
+  item = _items.release(view);
+}
+
+bool
+SharedBody::append(TSIOBuffer buff, TextView view)
+{
+  std::shared_lock lock(_mutex);
+  auto spot = _items.find(view);
+  if (nullptr == spot) {
+    return false;
+  }
+  auto &item = *spot;
+  std::call_once(item._once, [&]() {
+    item._buff = TSIOBufferCreate();
+    TSIOBufferWrite(item._buff, view.data(), view.size());
+    item._reader = TSIOBufferReaderAlloc(item._buff);
+  });
+  // This clones the blocks of @a _buff, the data is not copied. The reader is not consumed.
+  TSIOBufferCopy(buff, item._reader, view.size(), 0);
+  return true;
+}
+/* ------------------------------------------------------------------------ */
+FlushedStat::Registry &
+FlushedStat::registry()
+{
+  static Registry *registry = new Registry; // never destroyed, the flush task may be active at exit.
+  return *registry;
+}
+
+void
+FlushedStat::enroll(std::chrono::milliseconds period)
+{
+  auto &r = registry();
+  std::lock_guard lock(r._mutex);
+  _period     = period;
+  auto &group = r._groups[period];
+  group._stats.insert(this);
+  if (!group._task._cont) {
+    group._task = PerformAsTaskEvery(
+      [period]() {
+        auto &r = registry();
+        std::lock_guard lock(r._mutex);
+        for (auto stat : r._groups[period]._stats) {
+          stat->flush();
+        }
+      },
+      period);
+  }
+}
+
+void
+FlushedStat::withdraw()
+{
+  auto &r = registry();
+  std::lock_guard lock(r._mutex);
+  r._groups[_period]._stats.erase(this);
+  this->flush();
+}
+
+Rv<std::unique_ptr<ShardedStat>>
+ShardedStat::make(TextView const &name, std::chrono::milliseconds period, int value, bool persistent_p)
+{
+  auto &&[idx, errata]{plugin_stat_define(name, value, persistent_p)};
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+  std::unique_ptr<self_type> self{new self_type(idx)};
+  self->enroll(period);
+  return std::move(self);
+}
+
+ShardedStat::~ShardedStat()
+{
+  this->withdraw();
+}
+
+void
+ShardedStat::flush()
+{
+  int64_t n = 0;
+  for (auto &shard : _shards) {
+    n += shard._n.exchange(0, std::memory_order_relaxed);
+  }
+  if (n) {
+    plugin_stat_update(_idx, n);
+  }
+}
+
+Rv<std::unique_ptr<HistogramStat>>
+HistogramStat::make(TextView const &name, uint64_t min, uint64_t max, unsigned precision, bool persistent_p,
+                    std::chrono::milliseconds period)
+{
+  std::unique_ptr<self_type> self{new self_type(min, max, precision)};
+  std::string full_name;
+
+  // Define the stat @a name with @a suffix and return its index, or -1 with @a errata on failure.
+  Errata errata;
+  auto define = [&](TextView suffix) -> int {
+    auto &&[idx, stat_errata]{plugin_stat_define(swoc::bwprint(full_name, "{}.{}", name, suffix), 0, persistent_p)};
+    if (!stat_errata.is_ok()) {
+      if (errata.is_ok()) { // keep the first failure.
+        errata = std::move(stat_errata);
+      }
+      return -1;
+    }
+    return idx;
+  };
+
+  self->_count_idx = define("count");
+  self->_sum_idx   = define("sum");
+  auto &h          = self->_histogram;
+  std::string bucket;
+  for (unsigned idx = 0; idx < h.size(); ++idx) {
+    if (auto bound = h.upper_bound(idx); bound == Histogram::NO_BOUND) {
+      swoc::bwprint(bucket, "bucket.inf");
+    } else {
+      swoc::bwprint(bucket, "bucket.{}", bound);
+    }
+    self->_bucket_idx.push_back(define(bucket));
+  }
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+  self->enroll(period);
+  return std::move(self);
+}
+
+HistogramStat::~HistogramStat()
+{
+  this->withdraw();
+}
+
+void
+HistogramStat::flush()
+{
+  uint64_t sum = 0;
+  _counts.assign(_histogram.size(), 0);
+  _histogram.drain(_counts, sum);
+  uint64_t count = 0;
+  for (unsigned idx = 0; idx < _counts.size(); ++idx) {
+    if (_counts[idx]) {
+      plugin_stat_update(_bucket_idx[idx], _counts[idx]);
+      count += _counts[idx];
+    }
+  }
+  if (count) {
+    plugin_stat_update(_count_idx, count);
+    plugin_stat_update(_sum_idx, sum);
+  }
+}
+/* ------------------------------------------------------------------------ */
 // --- OpenSSL support ---
 int
 ssl_nid(swoc::TextView const &name)
@@ -30,6 +30,7 @@ using namespace swoc::literals;
 
 Global G;
 extern std::string glob_to_rxp(TextView glob);
+extern void Remap_Config_Info(std::string &text);
 
 const std::string Config::GLOBAL_ROOT_KEY{"txn_box"};
 const std::string Config::REMAP_ROOT_KEY{"."};
@@ -57,6 +58,9 @@ std::shared_mutex Plugin_Config_Mutex; // safe updating of the shared ptr.
 /// @internal Older gcc versions don't like the default constructor when used with @c atomic.
 static constexpr std::chrono::system_clock::time_point SYSTEM_CLOCK_NULL_TIME;
 std::atomic<std::chrono::system_clock::time_point> Plugin_Reloading{SYSTEM_CLOCK_NULL_TIME};
+/// Parsed YAML for configuration files, kept across reloads to avoid parsing unchanged files.
+/// @note Only used while @a Plugin_Reloading is set, or during plugin initialization.
+Config::YamlCache Plugin_Cfg_Cache;
 
 // Get a shared pointer to the configuration safely against updates.
 Config::Handle
@@ -104,7 +108,14 @@ Task_ConfigReload()
   auto t0             = std::chrono::system_clock::now();
   if (Plugin_Reloading.compare_exchange_strong(t_null, t0)) {
     std::shared_ptr cfg = std::make_shared<Config>();
-    auto errata         = cfg->load_cli_args(cfg, G._args, 1);
+    Plugin_Cfg_Cache.advance();
+    auto errata = cfg->load_cli_args(cfg, G._args, 1, &Plugin_Cfg_Cache);
+    Plugin_Cfg_Cache.sweep();
+    if (errata.is_ok()) {
+      if (auto sample = cfg->hook_time_sample(); sample) {
+        errata = Context::enable_hook_time(*sample);
+      }
+    }
     if (errata.is_ok()) {
       std::unique_lock lock(Plugin_Config_Mutex);
       Plugin_Config = cfg;
@@ -117,8 +128,9 @@ Task_ConfigReload()
     auto delta       = std::chrono::system_clock::now() - t0;
     std::string text;
     TS_DBG("%s",
-           swoc::bwprint(text, "{} files loaded in {} ms.", Plugin_Config->file_count(),
-                         std::chrono::duration_cast<std::chrono::milliseconds>(delta).count())
+           swoc::bwprint(text, "{} files loaded in {} ms - {} parsed, {} reused.", Plugin_Config->file_count(),
+                         std::chrono::duration_cast<std::chrono::milliseconds>(delta).count(), Plugin_Cfg_Cache.parse_count(),
+                         Plugin_Cfg_Cache.reuse_count())
              .c_str());
   } else { // because the exchange failed, @a t_null is the value that was in @a Plugin_Loading
     std::string err_str;
@@ -127,16 +139,33 @@ Task_ConfigReload()
   }
 }
 
+void
+Task_ConfigInfo()
+{
+  std::string text;
+  if (auto cfg = scoped_plugin_config(); cfg) {
+    swoc::bwprint(text, "{}: global configuration - {}", Config::PLUGIN_NAME, *cfg);
+    ts::Log_Note(text);
+  }
+  Remap_Config_Info(text);
+  auto &interner = StringInterner::instance();
+  swoc::bwprint(text, "{}: {} shared strings, {} bytes.", Config::PLUGIN_NAME, interner.count(), interner.size());
+  ts::Log_Note(text);
+}
+
 int
 CB_TxnBoxMsg(TSCont, TSEvent, void *data)
 {
   static constexpr TextView TAG{"txn_box."};
   static constexpr TextView RELOAD("reload");
+  static constexpr TextView INFO("info");
   auto msg = static_cast<TSPluginMsg *>(data);
   if (TextView tag{msg->tag, strlen(msg->tag)}; tag.starts_with_nocase(TAG)) {
     tag.remove_prefix(TAG.size());
     if (0 == strcasecmp(tag, RELOAD)) {
       ts::PerformAsTask(&Task_ConfigReload);
+    } else if (0 == strcasecmp(tag, INFO)) {
+      ts::PerformAsTask(&Task_ConfigInfo);
     }
   }
   return TS_SUCCESS;
@@ -158,10 +187,15 @@ TxnBoxInit()
 
   Plugin_Config = std::make_shared<Config>();
   auto t0       = std::chrono::system_clock::now();
-  auto errata   = Plugin_Config->load_cli_args(Plugin_Config, G._args, 1);
+  auto errata   = Plugin_Config->load_cli_args(Plugin_Config, G._args, 1, &Plugin_Cfg_Cache);
   if (!errata.is_ok()) {
     return errata;
   }
+  if (auto sample = Plugin_Config->hook_time_sample(); sample) {
+    if (errata = Context::enable_hook_time(*sample); !errata.is_ok()) {
+      return errata;
+    }
+  }
   auto delta = std::chrono::system_clock::now() - t0;
   std::string text;
   TS_DBG("%s",
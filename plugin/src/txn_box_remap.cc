@@ -7,6 +7,8 @@
 
 #include <string>
 #include <map>
+#include <mutex>
+#include <algorithm>
 #include <numeric>
 #include <getopt.h>
 
@@ -34,8 +36,52 @@ using namespace swoc::literals;
 
 /* ------------------------------------------------------------------------------------ */
 Config::YamlCache Remap_Cfg_Cache;
+/** Loaded remap configurations, for sharing among rules with identical arguments.
+ *
+ * Rules with the same arguments load the same files with the same root key and therefore produce
+ * identical configurations, which are immutable once loaded. Entries are valid only for the
+ * @a Remap_Cfg_Cache generation in which they were loaded so changed files are picked up on reload.
+ */
+struct RemapCfgShare {
+  std::mutex _mutex; ///< Lock for @a _map, as it is read during plugin message handling.
+  std::unordered_map<std::string, std::weak_ptr<Config>> _map; ///< Configurations by rule arguments.
+  unsigned _generation  = 0; ///< @a Remap_Cfg_Cache generation for @a _map.
+  unsigned _rule_count  = 0; ///< # of rules loaded in this generation.
+  unsigned _share_count = 0; ///< # of rules that used an existing configuration.
+  size_t _share_size    = 0; ///< Configuration memory not allocated due to sharing.
+
+  /// Discard configurations if the cache generation has changed.
+  void sync(unsigned generation);
+} Remap_Cfg_Share;
+
+void
+RemapCfgShare::sync(unsigned generation)
+{
+  if (generation != _generation) {
+    std::lock_guard lock(_mutex);
+    _map.clear();
+    _generation = generation;
+    _rule_count = _share_count = 0;
+    _share_size                = 0;
+  }
+}
 /// Static configuration for use in remap invocation when there is no global configuration.
 std::shared_ptr Remap_Static_Config = std::make_shared<Config>();
+/// Log resource use of the loaded remap configurations.
+void
+Remap_Config_Info(std::string &text)
+{
+  std::lock_guard lock(Remap_Cfg_Share._mutex);
+  for (auto const &[key, wp] : Remap_Cfg_Share._map) {
+    if (auto cfg = wp.lock(); cfg) {
+      // Arguments are null separated in the key, show them space separated.
+      std::string args{key};
+      std::replace(args.begin(), args.end(), '\0', ' ');
+      swoc::bwprint(text, "{}: remap configuration [{}] - {}", Config::PLUGIN_NAME, TextView(args).rtrim(' '), *cfg);
+      ts::Log_Note(text);
+    }
+  }
+}
 /* ------------------------------------------------------------------------------------ */
 class RemapContext
 {
@@ -59,10 +105,29 @@ TSRemapInit(TSRemapInterface *, char *errbuff, int errbuff_size)
   return TS_SUCCESS;
 };
 
+#if TS_VERSION_MAJOR >= 9
+void
+TSRemapPreConfigReload()
+{
+  // Files must be checked again for this reload, but parsed YAML for unchanged files is kept.
+  Remap_Cfg_Cache.advance();
+}
+#endif
+
 #if TS_VERSION_MAJOR >= 8
 void TSRemapPostConfigReload(TSRemapReloadStatus)
 {
-  Remap_Cfg_Cache.clear();
+  std::string text;
+  TS_DBG("%s", swoc::bwprint(text, "Remap configuration files - {} parsed, {} reused.", Remap_Cfg_Cache.parse_count(),
+                             Remap_Cfg_Cache.reuse_count()).c_str());
+  TS_DBG("%s", swoc::bwprint(text, "Remap configurations - {} rules, {} shared, {} bytes saved.", Remap_Cfg_Share._rule_count,
+                             Remap_Cfg_Share._share_count, Remap_Cfg_Share._share_size).c_str());
+  // Drop files no longer used by any rule.
+  Remap_Cfg_Cache.sweep();
+#if TS_VERSION_MAJOR < 9
+  // No pre-reload callback, so start the next generation now.
+  Remap_Cfg_Cache.advance();
+#endif
 }
 #endif
 
@@ -76,23 +141,47 @@ TSRemapNewInstance(int argc, char *argv[], void **ih, char *errbuff, int errbuff
     return TS_ERROR;
   }
 
-  auto cfg = std::make_shared<Config>();
-  swoc::MemSpan<char const *> rule_args{swoc::MemSpan<char *>(argv, argc).rebind<char const *>()};
-  cfg->mark_as_remap();
-  Errata errata = cfg->load_cli_args(cfg, rule_args,
-                                     2
+  std::shared_ptr<Config> cfg;
 #if TS_VERSION_MAJOR >= 8
-                                     // pre ATS 8 doesn't support remap reload callbacks, so the config cache can't be used.
-                                     ,
-                                     &Remap_Cfg_Cache
+  // Look for an already loaded configuration for the same arguments.
+  // pre ATS 8 doesn't support remap reload callbacks, so loaded configurations can't be shared.
+  std::string share_key;
+  for (int idx = 2; idx < argc; ++idx) {
+    share_key.append(argv[idx]).push_back('\0');
+  }
+  Remap_Cfg_Share.sync(Remap_Cfg_Cache.generation());
+  ++Remap_Cfg_Share._rule_count;
+  if (auto spot = Remap_Cfg_Share._map.find(share_key); spot != Remap_Cfg_Share._map.end()) {
+    if ((cfg = spot->second.lock())) {
+      ++Remap_Cfg_Share._share_count;
+      Remap_Cfg_Share._share_size += cfg->arena_size() + cfg->string_size();
+    }
+  }
 #endif
-  );
 
-  if (!errata.is_ok()) {
-    std::string text;
-    TSError("%s", swoc::bwprint(text, "{}", errata).c_str());
-    w.print("Error while parsing configuration for {} - see diagnostic log for more detail.\0", Config::PLUGIN_TAG);
-    return TS_ERROR;
+  if (!cfg) {
+    cfg = std::make_shared<Config>();
+    swoc::MemSpan<char const *> rule_args{swoc::MemSpan<char *>(argv, argc).rebind<char const *>()};
+    cfg->mark_as_remap();
+    Errata errata = cfg->load_cli_args(cfg, rule_args,
+                                       2
+#if TS_VERSION_MAJOR >= 8
+                                       // pre ATS 8 doesn't support remap reload callbacks, so the config cache can't be used.
+                                       ,
+                                       &Remap_Cfg_Cache
+#endif
+    );
+
+    if (!errata.is_ok()) {
+      std::string text;
+      TSError("%s", swoc::bwprint(text, "{}", errata).c_str());
+      w.print("Error while parsing configuration for {} - see diagnostic log for more detail.\0", Config::PLUGIN_TAG);
+      return TS_ERROR;
+    }
+#if TS_VERSION_MAJOR >= 8
+    std::lock_guard lock(Remap_Cfg_Share._mutex);
+    Remap_Cfg_Share._map[share_key] = cfg;
+#endif
   }
 
   G._remap_ctx_storage_required += cfg->reserved_ctx_storage_size();
@@ -0,0 +1,297 @@
+/** @file
+   User agent request body inspection.
+
+ * Copyright 2021 Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <cstring>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/MemSpan.h>
+#include <swoc/Errata.h>
+#include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/Directive.h"
+#include "txn_box/Extractor.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::MemSpan;
+using swoc::Errata;
+using swoc::Rv;
+using swoc::BufferWriter;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+/** Inspect the start of the user agent request body.
+ *
+ * A request transform captures at most the limit bytes of the body in to transaction memory. The
+ * body is passed through by cloning buffer blocks so nothing past the limit is copied. Output from
+ * the transform is held until the capture is complete, which delays the upstream request and
+ * therefore the directives in the @c do key, which are invoked on the proxy request hook.
+ *
+ * The transform requires the body length to be known in advance, as Traffic Server requires a
+ * content length for a transformed request. For other bodies nothing is captured and the body is
+ * not available, which is distinct from an empty body.
+ */
+class Do_ua_req_body_inspect : public Directive
+{
+  using self_type  = Do_ua_req_body_inspect; ///< Self reference type.
+  using super_type = Directive;              ///< Parent type.
+
+public:
+  static inline const std::string KEY{"ua-req-body-inspect"}; ///< Directive name.
+  static const HookMask HOOKS;                                ///< Valid hooks for directive.
+  /// Hook on which the @c do directives are invoked.
+  static constexpr Hook DO_HOOK = Hook::PREQ;
+
+  /// Transaction data for the captured body.
+  struct CtxInfo {
+    MemSpan<char> _body; ///< Capture buffer.
+    size_t _n     = 0;     ///< Bytes captured.
+    bool _done_p  = false; ///< Capture is complete.
+    bool _setup_p = false; ///< Capture has been set up.
+
+    /// @return The captured body.
+    TextView
+    body() const
+    {
+      return {_body.data(), _n};
+    }
+  };
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  size_t _limit = 0; ///< Maximum bytes to capture.
+  Handle _do;        ///< Directives to invoke after capture.
+
+  /// Per transaction transform state.
+  struct State {
+    CtxInfo *_info       = nullptr; ///< Capture data.
+    TSIOBuffer _out_buff = nullptr; ///< Output buffer.
+    TSVIO _out_vio       = nullptr; ///< Output VIO, set when the capture is complete.
+
+    /// Clean up the @c IOBuffer - see @c Do_upstream_rsp_body for why this is done here.
+    ~State() {
+      if (_out_buff) {
+        TSIOBufferDestroy(_out_buff);
+      }
+    }
+  };
+
+  /// Transform continuation callback.
+  static int transform(TSCont contp, TSEvent ev_code, void *);
+
+  /** Copy body data in to the capture buffer.
+   *
+   * @param info Capture data.
+   * @param reader Body reader.
+   * @param n Bytes available in @a reader.
+   */
+  static void capture(CtxInfo &info, TSIOBufferReader reader, int64_t n);
+};
+
+const HookMask Do_ua_req_body_inspect::HOOKS{MaskFor({Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP})};
+
+void
+Do_ua_req_body_inspect::capture(CtxInfo &info, TSIOBufferReader reader, int64_t n)
+{
+  for (auto block = TSIOBufferReaderStart(reader); block && n > 0 && info._n < info._body.size();
+       block      = TSIOBufferBlockNext(block)) {
+    int64_t avail = 0;
+    auto data     = TSIOBufferBlockReadStart(block, reader, &avail);
+    avail         = std::min(avail, n);
+    n -= avail;
+    auto k = std::min<size_t>(avail, info._body.size() - info._n);
+    memcpy(info._body.data() + info._n, data, k);
+    info._n += k;
+  }
+}
+
+int
+Do_ua_req_body_inspect::transform(TSCont contp, TSEvent ev_code, void *)
+{
+  if (TSVConnClosedGet(contp)) {
+    // IOBuffer is cleaned up at transaction close, not here.
+    TSContDestroy(contp);
+    return 0;
+  }
+
+  auto in_vio = TSVConnWriteVIOGet(contp);
+  switch (ev_code) {
+  case TS_EVENT_ERROR:
+    TSContCall(TSVIOContGet(in_vio), TS_EVENT_ERROR, in_vio);
+    break;
+  case TS_EVENT_VCONN_WRITE_COMPLETE:
+    TSVConnShutdown(TSTransformOutputVConnGet(contp), 0, 1);
+    break;
+  default: {
+    auto state = static_cast<State *>(TSContDataGet(contp));
+    if (nullptr == state || (state->_out_vio && TSVIONTodoGet(in_vio) <= 0)) {
+      break; // nothing left to do.
+    }
+    auto &info = *state->_info;
+    if (!state->_out_buff) {
+      state->_out_buff = TSIOBufferCreate();
+    }
+
+    if (TSVIOBufferGet(in_vio)) {
+      if (auto todo = TSVIONTodoGet(in_vio); todo > 0) {
+        auto reader = TSVIOReaderGet(in_vio);
+        if (auto avail = std::min(todo, TSIOBufferReaderAvail(reader)); avail > 0) {
+          if (!info._done_p) {
+            capture(info, reader, avail);
+          }
+          TSIOBufferCopy(state->_out_buff, reader, avail, 0); // clones blocks, no data copy.
+          TSIOBufferReaderConsume(reader, avail);
+          TSVIONDoneSet(in_vio, TSVIONDoneGet(in_vio) + avail);
+        }
+      }
+    }
+
+    auto todo = TSVIOBufferGet(in_vio) ? TSVIONTodoGet(in_vio) : 0;
+    if (info._n >= info._body.size() || todo <= 0) {
+      info._done_p = true;
+    }
+    // Output is started only when the capture is done, holding the upstream request until then.
+    if (info._done_p && !state->_out_vio) {
+      state->_out_vio = TSVConnWrite(TSTransformOutputVConnGet(contp), contp, TSIOBufferReaderAlloc(state->_out_buff),
+                                     TSVIONBytesGet(in_vio));
+    }
+    if (state->_out_vio) {
+      TSVIOReenable(state->_out_vio);
+    }
+    if (TSVIOBufferGet(in_vio)) {
+      TSContCall(TSVIOContGet(in_vio), todo > 0 ? TS_EVENT_VCONN_WRITE_READY : TS_EVENT_VCONN_WRITE_COMPLETE, in_vio);
+    }
+  } break;
+  }
+
+  return 0;
+}
+
+Errata
+Do_ua_req_body_inspect::invoke(Context &ctx)
+{
+  static constexpr TextView CONTENT_LENGTH    = "Content-Length";
+  static constexpr TextView TRANSFER_ENCODING = "Transfer-Encoding";
+
+  auto info = ctx.obtain_named_object<CtxInfo>(KEY);
+  if (!info->_setup_p) { // Only the first invocation sets up the capture.
+    info->_setup_p = true;
+    if (auto hdr{ctx.ua_req_hdr()}; hdr.is_valid()) {
+      if (auto field{hdr.field(CONTENT_LENGTH)}; field.is_valid()) {
+        TextView parsed;
+        auto length = swoc::svtou(field.value(), &parsed);
+        if (parsed.size() != field.value().size()) {
+          // Invalid length, leave the capture incomplete so the body is not available.
+        } else if (length == 0) {
+          info->_done_p = true; // empty body, there won't be a transform.
+        } else {
+          info->_body  = ctx.alloc_span<char>(std::min<size_t>(length, _limit));
+          auto state   = ctx.make<State>();
+          state->_info = info;
+          ctx.mark_for_cleanup(state);
+          auto cont = TSTransformCreate(&self_type::transform, ctx._txn);
+          TSContDataSet(cont, state);
+          TSHttpTxnHookAdd(ctx._txn, TS_HTTP_REQUEST_TRANSFORM_HOOK, cont);
+        }
+      } else if (!hdr.field(TRANSFER_ENCODING).is_valid()) {
+        info->_done_p = true; // no body.
+      } // else a body of unknown length, which can not be captured - leave the body not available.
+    }
+  }
+  return ctx.on_hook_do(DO_HOOK, _do.get());
+}
+
+Rv<Directive::Handle>
+Do_ua_req_body_inspect::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &,
+                             swoc::TextView const &, YAML::Node key_value)
+{
+  auto &&[expr, errata]{cfg.parse_expr(key_value)};
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+    return std::move(errata);
+  }
+  feature_type_for<INTEGER> limit = -1;
+  if (expr.is_literal()) {
+    limit = std::get<Expr::LITERAL>(expr._raw).as_integer(-1);
+  }
+  if (limit <= 0) {
+    return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a literal positive integer.)", KEY, drtv_node.Mark());
+  }
+
+  YAML::Node do_node{drtv_node[DO_KEY]};
+  if (!do_node) {
+    return Errata(S_ERROR, R"(The required "{}" key was not found in the "{}" directive at {}.)", DO_KEY, KEY, drtv_node.Mark());
+  }
+  auto save = cfg._hook;
+  cfg._hook = DO_HOOK;
+  auto &&[do_handle, do_errata]{cfg.parse_directive(do_node)};
+  cfg._hook = save;
+  if (!do_errata.is_ok()) {
+    do_errata.note(R"(While parsing "{}" key at {} in "{}" directive at {}.)", DO_KEY, do_node.Mark(), KEY, drtv_node.Mark());
+    return std::move(do_errata);
+  }
+  cfg.reserve_slot(DO_HOOK);
+
+  auto self    = new self_type;
+  self->_limit = limit;
+  self->_do    = std::move(do_handle);
+  return Handle(self);
+}
+
+/* ------------------------------------------------------------------------------------ */
+/// The captured user agent request body.
+class Ex_ua_req_body : public StringExtractor
+{
+public:
+  static constexpr TextView NAME{"ua-req-body"};
+
+  Feature extract(Context &ctx, Spec const &spec) override;
+};
+
+Feature
+Ex_ua_req_body::extract(Context &ctx, Spec const &)
+{
+  if (auto info = ctx.named_object<Do_ua_req_body_inspect::CtxInfo>(Do_ua_req_body_inspect::KEY);
+      info && info->_done_p) {
+    return FeatureView::Direct(info->body());
+  }
+  return NIL_FEATURE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+Ex_ua_req_body ua_req_body;
+
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Config::define<Do_ua_req_body_inspect>();
+  Extractor::define(Ex_ua_req_body::NAME, &ua_req_body);
+  return true;
+}();
+} // namespace
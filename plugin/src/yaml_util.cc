@@ -67,6 +67,12 @@ yaml_load(swoc::file::path const &path)
     return Errata(S_ERROR, R"(Unable to load file "{}" - {}.)", path, ec);
   }
 
+  return yaml_parse(content, path);
+}
+
+Rv<YAML::Node>
+yaml_parse(std::string const &content, swoc::file::path const &path)
+{
   YAML::Node root;
   try {
     root = YAML::Load(content);
@@ -0,0 +1,20 @@
+# @file
+#
+# Copyright 2021, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+
+Test.Summary = '''
+Upstream response body rewriting, with rules as a list and as a map.
+'''
+
+r = Test.TxnBoxTestAndRun("Body rewrite", "body_rewrite.replay.yaml"
+                          , config_path='Auto', config_key="meta.txn_box.global"
+                          , remap=[ [ "http://base.ex/" ] ]
+                          )
+ts = r.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+    , 'proxy.config.http.cache.http': 0
+})
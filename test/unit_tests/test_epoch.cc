@@ -0,0 +1,197 @@
+/** @file
+ *  Tests and benchmark for epoch based reclamation.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "txn_box/Epoch.h"
+
+namespace
+{
+struct Data {
+  explicit Data(int v) : _value(v) {}
+  ~Data() { ++Destroyed; }
+  int _value;
+  static inline std::atomic<int> Destroyed{0};
+};
+
+/** Run @a f on @a n_threads threads, @a n_loops times each.
+ *
+ * @param sum [out] Sum of the return values of @a f.
+ * @return The elapsed time in milliseconds.
+ */
+template <typename F>
+auto
+run_threads(unsigned n_threads, unsigned n_loops, std::atomic<long> &sum, F &&f)
+{
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      long local = 0; // avoid contention on @a sum in the loop.
+      for (unsigned k = 0; k < n_loops; ++k) {
+        local += f(t * n_loops + k);
+      }
+      sum += local;
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+TEST_CASE("Epoch", "[epoch]")
+{
+  Data::Destroyed = 0;
+  {
+    Epoch epoch;
+    epoch.retire(std::make_shared<Data>(1));
+    REQUIRE(Data::Destroyed == 1); // no readers.
+    REQUIRE(epoch.retired_count() == 0);
+
+    auto g1 = epoch.enter();
+    epoch.retire(std::make_shared<Data>(2));
+    REQUIRE(Data::Destroyed == 1);
+    auto g2 = epoch.enter(); // later reader doesn't keep earlier retired data.
+    epoch.reclaim();
+    REQUIRE(Data::Destroyed == 1);
+    g1.release();
+    epoch.retire(std::make_shared<Data>(3));
+    REQUIRE(Data::Destroyed == 2); // only data retired while @a g2 was active is kept.
+    REQUIRE(epoch.retired_count() == 1);
+
+    Epoch::Guard g3{std::move(g2)}; // moving the guard keeps the data.
+    epoch.reclaim();
+    REQUIRE(Data::Destroyed == 2);
+    std::thread([&]() { g3.release(); }).join(); // may be released on another thread.
+    epoch.reclaim();
+    REQUIRE(Data::Destroyed == 3);
+
+    g1 = epoch.enter();
+    epoch.retire(std::make_shared<Data>(4));
+  }
+  REQUIRE(Data::Destroyed == 4);
+}
+
+TEST_CASE("Epoch reference", "[epoch]")
+{
+  // A reader that takes a reference in the epoch and then leaves keeps only that version.
+  struct Version : public Data, public std::enable_shared_from_this<Version> {
+    using Data::Data;
+  };
+  Data::Destroyed = 0;
+  Epoch epoch;
+  std::shared_ptr<Version> handle = std::make_shared<Version>(0);
+  std::atomic<Version const *> current{handle.get()};
+
+  std::shared_ptr<Version const> ref;
+  {
+    auto guard = epoch.enter();
+    ref        = current.load()->shared_from_this();
+  }
+  for (int k = 1; k <= 10; ++k) {
+    auto update = std::make_shared<Version>(k);
+    current     = update.get();
+    std::swap(handle, update);
+    epoch.retire(std::move(update));
+  }
+  epoch.reclaim();
+  REQUIRE(epoch.retired_count() == 0);
+  REQUIRE(Data::Destroyed == 9); // every retired version except the referenced one.
+  REQUIRE(ref->_value == 0);
+  ref.reset();
+  REQUIRE(Data::Destroyed == 10);
+}
+
+TEST_CASE("Epoch threads", "[epoch]")
+{
+  static constexpr unsigned N_LOOPS = 100000;
+  unsigned n_threads                = std::max(2u, std::thread::hardware_concurrency());
+
+  Epoch epoch;
+  std::atomic<std::string const *> current{nullptr};
+  std::shared_ptr<std::string> handle = std::make_shared<std::string>("value");
+  current                             = handle.get();
+  std::atomic<bool> done{false};
+  std::atomic<long> errors{0};
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&]() {
+      long local = 0;
+      for (unsigned k = 0; k < N_LOOPS; ++k) {
+        auto guard = epoch.enter();
+        auto text  = current.load();
+        if (*text != "value") {
+          ++local;
+        }
+      }
+      errors += local;
+    });
+  }
+  std::thread writer([&]() {
+    while (!done) {
+      auto update = std::make_shared<std::string>("value");
+      current     = update.get();
+      std::swap(handle, update);
+      epoch.retire(std::move(update));
+    }
+  });
+  for (auto &t : threads) {
+    t.join();
+  }
+  done = true;
+  writer.join();
+  REQUIRE(errors == 0);
+  epoch.reclaim();
+  REQUIRE(epoch.retired_count() == 0);
+}
+
+TEST_CASE("Epoch benchmark", "[epoch][perf]")
+{
+  static constexpr unsigned N_LOOPS = 1000000;
+  static constexpr unsigned N_KEYS  = 4096;
+  unsigned n_threads                = std::max(2u, std::thread::hardware_concurrency());
+
+  // Sorted keys, looked up with a binary search as in an IP space.
+  auto table = std::make_shared<std::vector<unsigned>>();
+  for (unsigned k = 0; k < N_KEYS; ++k) {
+    table->push_back(2 * k);
+  }
+  auto lookup = [](std::vector<unsigned> const &keys, unsigned key) -> long {
+    return std::binary_search(keys.begin(), keys.end(), (key * 2) % (2 * N_KEYS)) ? 1 : 0;
+  };
+
+  std::shared_mutex mutex;
+  std::shared_ptr<std::vector<unsigned>> locked = table;
+  Epoch epoch;
+  std::atomic<std::vector<unsigned> const *> current{table.get()};
+
+  std::atomic<long> sum{0};
+  auto lock_ms = run_threads(n_threads, N_LOOPS, sum, [&](unsigned key) {
+    std::shared_lock lock(mutex);
+    return lookup(*locked, key);
+  });
+  auto epoch_ms = run_threads(n_threads, N_LOOPS, sum, [&](unsigned key) {
+    auto guard = epoch.enter();
+    return lookup(*current.load(std::memory_order_acquire), key);
+  });
+  REQUIRE(sum == 2L * n_threads * N_LOOPS);
+
+  std::cout << "Epoch - " << n_threads << " threads, " << N_LOOPS << " lookups each: shared lock " << lock_ms
+            << " milliseconds, epoch guard " << epoch_ms << " milliseconds." << std::endl;
+}
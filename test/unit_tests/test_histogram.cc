@@ -0,0 +1,95 @@
+/** @file
+ *  Tests for the log-linear histogram.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "txn_box/Histogram.h"
+
+TEST_CASE("Histogram buckets", "[histogram]")
+{
+  for (unsigned precision : {0, 1, 2, 4}) {
+    Histogram h{100, 10000000, precision};
+    REQUIRE(h.upper_bound(h.size() - 1) == Histogram::NO_BOUND);
+    // Bounds strictly increase.
+    for (unsigned idx = 1; idx < h.size(); ++idx) {
+      REQUIRE(h.upper_bound(idx - 1) < h.upper_bound(idx));
+    }
+    // Every value in range is in the bucket that covers it, and the bucket is narrow enough.
+    for (uint64_t v = 100; v <= 10000000; v += 1 + v / 97) {
+      auto idx = h.bucket_for(v);
+      REQUIRE(idx + 1 < h.size());
+      REQUIRE(v <= h.upper_bound(idx));
+      if (idx > 0) {
+        auto lower = h.upper_bound(idx - 1) + 1;
+        REQUIRE(lower <= v);
+        REQUIRE((h.upper_bound(idx) - lower) <= (v >> precision));
+      }
+    }
+  }
+
+  Histogram h{1, 1000, 2};
+  REQUIRE(h.bucket_for(0) == 0);
+  REQUIRE(h.bucket_for(1) == 0);
+  REQUIRE(h.upper_bound(0) == 1);
+  REQUIRE(h.bucket_for(3) == 2);
+  REQUIRE(h.bucket_for(4) == 3);
+  REQUIRE(h.upper_bound(4) == 5); // width 2 starting at 4.
+  REQUIRE(h.bucket_for(5) == 4);
+  REQUIRE(h.bucket_for(1000) == h.size() - 2);
+  REQUIRE(h.bucket_for(1023) == h.size() - 2);
+  REQUIRE(h.bucket_for(1024) == h.size() - 1);
+  REQUIRE(h.bucket_for(Histogram::NO_BOUND) == h.size() - 1);
+
+  Histogram h0{0, 0, 0};
+  REQUIRE(h0.size() == 2);
+  REQUIRE(h0.bucket_for(0) == 0);
+  REQUIRE(h0.bucket_for(1) == 1);
+}
+
+TEST_CASE("Histogram record", "[histogram]")
+{
+  static constexpr unsigned N_THREADS = 8;
+  static constexpr uint64_t N         = 100000;
+  Histogram h{1, 1 << 20, 2};
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < N_THREADS; ++t) {
+    threads.emplace_back([&h]() {
+      for (uint64_t v = 0; v < N; ++v) {
+        h.record(v);
+      }
+    });
+  }
+  std::vector<uint64_t> counts;
+  uint64_t sum = 0;
+  h.drain(counts, sum); // concurrent with recording, must not lose values.
+  for (auto &t : threads) {
+    t.join();
+  }
+  h.drain(counts, sum);
+
+  REQUIRE(counts.size() == h.size());
+  uint64_t total = 0;
+  for (auto n : counts) {
+    total += n;
+  }
+  REQUIRE(total == N_THREADS * N);
+  REQUIRE(sum == N_THREADS * (N * (N - 1) / 2));
+  REQUIRE(counts[h.bucket_for(0)] == 2 * N_THREADS); // 0 and 1.
+  REQUIRE(counts.back() == 0);
+
+  // Drained, nothing left.
+  std::vector<uint64_t> empty;
+  uint64_t empty_sum = 0;
+  h.drain(empty, empty_sum);
+  for (auto n : empty) {
+    REQUIRE(n == 0);
+  }
+  REQUIRE(empty_sum == 0);
+}
@@ -0,0 +1,132 @@
+/** @file
+ *  Tests and benchmark for streaming text substitution.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "txn_box/StreamRewriter.h"
+
+using swoc::TextView;
+
+namespace
+{
+pcre2_code *
+compile(TextView pattern)
+{
+  int errc       = 0;
+  size_t err_off = 0;
+  return pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern.data()), pattern.size(), 0, &errc, &err_off, nullptr);
+}
+
+/// Rewrite @a text in chunks of @a chunk_size.
+std::string
+rewrite(swoc::MemSpan<StreamRewriter::Rule const> rules, TextView text, size_t chunk_size, size_t carry = StreamRewriter::DEFAULT_CARRY)
+{
+  std::string result;
+  StreamRewriter rw(rules, carry);
+  auto out = [&](TextView t) { result.append(t.data(), t.size()); };
+  while (text) {
+    rw.write(text.prefix(chunk_size), false, out);
+    text.remove_prefix(chunk_size);
+  }
+  rw.write(TextView{}, true, out);
+  return result;
+}
+} // namespace
+
+TEST_CASE("StreamRewriter", "[rewrite]")
+{
+  auto rxp = compile(R"(https?://cdn[0-9]+\.example\.com)");
+  StreamRewriter::Rule rules[] = {
+    {"http://old.example.com", nullptr, "https://new.example.com"},
+    {{}, rxp, "https://cdn.example.com"},
+  };
+  swoc::MemSpan<StreamRewriter::Rule const> span{rules, 2};
+
+  std::string text = R"(<a href="http://old.example.com/x">x</a> <img src="http://cdn12.example.com/i.png">)"
+                     R"( http://old.example.co <script src="https://cdn7.example.com/s.js"></script>)";
+  std::string expected = R"(<a href="https://new.example.com/x">x</a> <img src="https://cdn.example.com/i.png">)"
+                         R"( http://old.example.co <script src="https://cdn.example.com/s.js"></script>)";
+
+  // Every chunk size, so that matches are split at every possible place.
+  for (size_t chunk = 1; chunk <= text.size(); ++chunk) {
+    INFO("chunk size " << chunk);
+    REQUIRE(rewrite(span, text, chunk) == expected);
+  }
+
+  // Earlier rule is preferred for matches at the same place.
+  StreamRewriter::Rule overlap[] = {
+    {"abc", nullptr, "1"},
+    {"abcd", nullptr, "2"},
+    {"bc", nullptr, "3"},
+  };
+  REQUIRE(rewrite({overlap, 3}, "xabcdx abx", 2) == "x1dx abx");
+
+  // Matches longer than the carry limit are missed across boundaries, but output is not lost.
+  StreamRewriter::Rule long_rule[] = {
+    {"0123456789", nullptr, "X"},
+  };
+  REQUIRE(rewrite({long_rule, 1}, "a0123456789b", 4, 4) == "a0123456789b");
+  REQUIRE(rewrite({long_rule, 1}, "a0123456789b", 4, 16) == "aXb");
+
+  // A possible match longer than the carry limit doesn't hide matches of other rules inside it.
+  auto open_rxp = compile(R"(\[[^\]]*\])");
+  StreamRewriter::Rule nested[] = {
+    {{}, open_rxp, "[]"},
+    {"old", nullptr, "new"},
+  };
+  std::string open_text     = "x [ old old old old old old old old old old end old";
+  std::string open_expected = "x [ new new new new new new new new new new end new";
+  for (size_t chunk = 1; chunk <= open_text.size(); ++chunk) {
+    INFO("chunk size " << chunk);
+    REQUIRE(rewrite({nested, 2}, open_text, chunk, 8) == open_expected);
+  }
+  REQUIRE(rewrite({nested, 2}, "a [ old ] old", 1, 8) == "a [] new");
+  pcre2_code_free(open_rxp);
+
+  pcre2_code_free(rxp);
+}
+
+TEST_CASE("StreamRewriter benchmark", "[rewrite][perf]")
+{
+  static constexpr size_t BODY_SIZE  = 64 << 20;
+  static constexpr size_t CHUNK_SIZE = 32 << 10;
+
+  auto rxp = compile(R"(https?://cdn[0-9]+\.example\.com)");
+  StreamRewriter::Rule rules[] = {
+    {"http://old.example.com", nullptr, "https://new.example.com"},
+    {{}, rxp, "https://cdn.example.com"},
+  };
+
+  std::string line = R"(<p>Some text <a href="http://old.example.com/page">link</a> <img src="http://cdn3.example.com/a.png"></p>)"
+                     "\n";
+  std::string body;
+  body.reserve(BODY_SIZE + line.size());
+  while (body.size() < BODY_SIZE) {
+    body += line;
+  }
+
+  size_t n_out = 0;
+  StreamRewriter rw({rules, 2});
+  TextView text = body;
+  auto start    = std::chrono::steady_clock::now();
+  while (text) {
+    rw.write(text.prefix(CHUNK_SIZE), false, [&](TextView t) { n_out += t.size(); });
+    text.remove_prefix(CHUNK_SIZE);
+  }
+  rw.write(TextView{}, true, [&](TextView t) { n_out += t.size(); });
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  REQUIRE(n_out > body.size());
+  REQUIRE(rw.peak_carry() <= StreamRewriter::DEFAULT_CARRY);
+  std::cout << "StreamRewriter - " << (body.size() >> 20) << " MB in " << CHUNK_SIZE << " byte chunks: " << ms << " milliseconds, "
+            << (ms ? (body.size() >> 20) * 1000 / ms : 0) << " MB/sec, peak carry " << rw.peak_carry() << " bytes." << std::endl;
+  pcre2_code_free(rxp);
+}
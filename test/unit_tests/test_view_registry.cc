@@ -0,0 +1,57 @@
+/** @file
+ *  Tests for the view registry.
+ *
+ * Copyright 2021, Verizon Media .
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch.hpp"
+
+#include <string_view>
+
+#include "txn_box/ViewRegistry.h"
+
+namespace
+{
+struct Item {
+  explicit Item(size_t size) : _size(size) {}
+  size_t _size;
+};
+} // namespace
+
+TEST_CASE("ViewRegistry", "[view-registry]")
+{
+  static constexpr char TEXT[] = "Delain - Mother Machine";
+  std::string_view view{TEXT};
+  ViewRegistry<Item> registry;
+
+  REQUIRE(registry.find(view) == nullptr);
+  REQUIRE(registry.release(view) == nullptr); // not registered, ignored.
+
+  // Two publishers of the same view, e.g. interned literals in the old and new config.
+  auto &item = registry.acquire(view);
+  REQUIRE(item._size == view.size());
+  REQUIRE(&registry.acquire(view) == &item);
+  REQUIRE(registry.count(view) == 2);
+  REQUIRE(registry.size() == 1);
+
+  // A different size at the same address is a different view.
+  auto prefix = view.substr(0, 6);
+  registry.acquire(prefix);
+  REQUIRE(registry.size() == 2);
+  REQUIRE(registry.find(prefix) != registry.find(view));
+  REQUIRE(registry.release(prefix) != nullptr);
+  REQUIRE(registry.find(prefix) == nullptr);
+
+  // The first release leaves the view for the other publisher.
+  REQUIRE(registry.release(view) == nullptr);
+  REQUIRE(registry.find(view) == &item);
+  REQUIRE(registry.count(view) == 1);
+
+  // The last release removes it and hands the item back.
+  auto last = registry.release(view);
+  REQUIRE(last.get() == &item);
+  REQUIRE(registry.find(view) == nullptr);
+  REQUIRE(registry.count(view) == 0);
+  REQUIRE(registry.size() == 0);
+}
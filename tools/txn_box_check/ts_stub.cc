@@ -0,0 +1,260 @@
+/** @file
+   Stub of the Traffic Server plugin API for offline tools.
+
+   The plugin sources are linked without Traffic Server, therefore every TS API function they use
+   must be defined here. The API is C linkage so only the name is needed to resolve the link. Most of
+   the functions are never called while loading a configuration. Those that are return zero, which
+   is @c TS_SUCCESS, @c nullptr or 0 as appropriate. A few are implemented to make loading work
+   (diagnostics, the configuration directory, stat lookup).
+
+   @note ts/ts.h is deliberately not included, as the stub signatures do not match.
+
+ * Copyright 2021, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+#include <limits.h>
+
+/// Enable debug output - set by the tool.
+bool Stub_Debug_P = false;
+
+namespace
+{
+constexpr int STUB_TS_ERROR = -1; ///< Value of @c TS_ERROR.
+
+void
+print_diag(char const *level, char const *fmt, va_list args)
+{
+  fprintf(stderr, "[%s] ", level);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+}
+} // namespace
+
+// Used by @c TS_DBG in offline builds, see ts_util.h.
+void
+txn_box_standalone_debug(char const *fmt, ...)
+{
+  if (Stub_Debug_P) {
+    va_list args;
+    va_start(args, fmt);
+    print_diag("debug", fmt, args);
+    va_end(args);
+  }
+}
+
+extern "C" {
+
+void
+TSDebug(char const *, char const *fmt, ...)
+{
+  if (Stub_Debug_P) {
+    va_list args;
+    va_start(args, fmt);
+    print_diag("debug", fmt, args);
+    va_end(args);
+  }
+}
+
+void
+TSNote(char const *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  print_diag("note", fmt, args);
+  va_end(args);
+}
+
+void
+TSWarning(char const *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  print_diag("warning", fmt, args);
+  va_end(args);
+}
+
+void
+TSError(char const *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  print_diag("error", fmt, args);
+  va_end(args);
+}
+
+/// Relative configuration paths are resolved against the working directory.
+char const *
+TSConfigDirGet()
+{
+  static std::string dir;
+  if (dir.empty()) {
+    char buff[PATH_MAX];
+    dir = getcwd(buff, sizeof(buff)) ? buff : ".";
+  }
+  return dir.c_str();
+}
+
+/// There are no existing stats.
+int
+TSStatFindName(char const *, int *)
+{
+  return STUB_TS_ERROR;
+}
+
+char const *TS_MIME_FIELD_CONTENT_LENGTH = "Content-Length";
+char const *TS_MIME_FIELD_CONTENT_TYPE   = "Content-Type";
+char const *TS_MIME_FIELD_HOST           = "Host";
+char const *TS_MIME_FIELD_LOCATION       = "Location";
+int TS_MIME_LEN_CONTENT_LENGTH           = 14;
+int TS_MIME_LEN_CONTENT_TYPE             = 12;
+int TS_MIME_LEN_HOST                     = 4;
+int TS_MIME_LEN_LOCATION                 = 8;
+char const *TS_URL_SCHEME_HTTP           = "http";
+char const *TS_URL_SCHEME_HTTPS          = "https";
+int TS_URL_LEN_HTTP                      = 4;
+int TS_URL_LEN_HTTPS                     = 5;
+
+#define TXN_BOX_TS_STUB(name) \
+  intptr_t name()             \
+  {                           \
+    return 0;                 \
+  }
+
+TXN_BOX_TS_STUB(TSActionCancel)
+TXN_BOX_TS_STUB(TSCacheUrlSet)
+TXN_BOX_TS_STUB(TSContCall)
+TXN_BOX_TS_STUB(TSContCreate)
+TXN_BOX_TS_STUB(TSContDataGet)
+TXN_BOX_TS_STUB(TSContDataSet)
+TXN_BOX_TS_STUB(TSContDestroy)
+TXN_BOX_TS_STUB(TSContMutexGet)
+TXN_BOX_TS_STUB(TSContScheduleEveryOnPool)
+TXN_BOX_TS_STUB(TSContScheduleOnPool)
+TXN_BOX_TS_STUB(TSHandleMLocRelease)
+TXN_BOX_TS_STUB(TSHttpHdrMethodGet)
+TXN_BOX_TS_STUB(TSHttpHdrReasonGet)
+TXN_BOX_TS_STUB(TSHttpHdrReasonSet)
+TXN_BOX_TS_STUB(TSHttpHdrStatusGet)
+TXN_BOX_TS_STUB(TSHttpHdrStatusSet)
+TXN_BOX_TS_STUB(TSHttpHdrUrlGet)
+TXN_BOX_TS_STUB(TSHttpHdrUrlSet)
+TXN_BOX_TS_STUB(TSHttpHookAdd)
+TXN_BOX_TS_STUB(TSHttpSsnClientAddrGet)
+TXN_BOX_TS_STUB(TSHttpSsnClientProtocolStackContains)
+TXN_BOX_TS_STUB(TSHttpSsnClientProtocolStackGet)
+TXN_BOX_TS_STUB(TSHttpSsnClientVConnGet)
+TXN_BOX_TS_STUB(TSHttpSsnIncomingAddrGet)
+TXN_BOX_TS_STUB(TSHttpSsnTransactionCount)
+TXN_BOX_TS_STUB(TSHttpTxnArgGet)
+TXN_BOX_TS_STUB(TSHttpTxnArgIndexNameLookup)
+TXN_BOX_TS_STUB(TSHttpTxnArgIndexReserve)
+TXN_BOX_TS_STUB(TSHttpTxnArgSet)
+TXN_BOX_TS_STUB(TSHttpTxnClientFdGet)
+TXN_BOX_TS_STUB(TSHttpTxnClientReqGet)
+TXN_BOX_TS_STUB(TSHttpTxnClientRespGet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigFind)
+TXN_BOX_TS_STUB(TSHttpTxnConfigFloatGet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigFloatSet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigIntGet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigIntSet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigStringGet)
+TXN_BOX_TS_STUB(TSHttpTxnConfigStringSet)
+TXN_BOX_TS_STUB(TSHttpTxnDebugSet)
+TXN_BOX_TS_STUB(TSHttpTxnEffectiveUrlStringGet)
+TXN_BOX_TS_STUB(TSHttpTxnErrorBodySet)
+TXN_BOX_TS_STUB(TSHttpTxnHookAdd)
+TXN_BOX_TS_STUB(TSHttpTxnIsInternal)
+TXN_BOX_TS_STUB(TSHttpTxnOutgoingAddrGet)
+TXN_BOX_TS_STUB(TSHttpTxnPristineUrlGet)
+TXN_BOX_TS_STUB(TSHttpTxnReenable)
+TXN_BOX_TS_STUB(TSHttpTxnServerAddrGet)
+TXN_BOX_TS_STUB(TSHttpTxnServerAddrSet)
+TXN_BOX_TS_STUB(TSHttpTxnServerProtocolStackContains)
+TXN_BOX_TS_STUB(TSHttpTxnServerProtocolStackGet)
+TXN_BOX_TS_STUB(TSHttpTxnServerReqGet)
+TXN_BOX_TS_STUB(TSHttpTxnServerRespGet)
+TXN_BOX_TS_STUB(TSHttpTxnServerSsnTransactionCount)
+TXN_BOX_TS_STUB(TSHttpTxnServerVConnGet)
+TXN_BOX_TS_STUB(TSHttpTxnSsnGet)
+TXN_BOX_TS_STUB(TSHttpTxnStatusSet)
+TXN_BOX_TS_STUB(TSIOBufferBlockNext)
+TXN_BOX_TS_STUB(TSIOBufferBlockReadStart)
+TXN_BOX_TS_STUB(TSIOBufferCopy)
+TXN_BOX_TS_STUB(TSIOBufferCreate)
+TXN_BOX_TS_STUB(TSIOBufferDestroy)
+TXN_BOX_TS_STUB(TSIOBufferReaderAlloc)
+TXN_BOX_TS_STUB(TSIOBufferReaderAvail)
+TXN_BOX_TS_STUB(TSIOBufferReaderConsume)
+TXN_BOX_TS_STUB(TSIOBufferReaderStart)
+TXN_BOX_TS_STUB(TSIOBufferSizedCreate)
+TXN_BOX_TS_STUB(TSIOBufferWrite)
+TXN_BOX_TS_STUB(TSLifecycleHookAdd)
+TXN_BOX_TS_STUB(TSMimeHdrFieldAppend)
+TXN_BOX_TS_STUB(TSMimeHdrFieldCreateNamed)
+TXN_BOX_TS_STUB(TSMimeHdrFieldDestroy)
+TXN_BOX_TS_STUB(TSMimeHdrFieldFind)
+TXN_BOX_TS_STUB(TSMimeHdrFieldNameGet)
+TXN_BOX_TS_STUB(TSMimeHdrFieldNextDup)
+TXN_BOX_TS_STUB(TSMimeHdrFieldValueStringGet)
+TXN_BOX_TS_STUB(TSMimeHdrFieldValueStringSet)
+TXN_BOX_TS_STUB(TSMutexCreate)
+TXN_BOX_TS_STUB(TSMutexLockTry)
+TXN_BOX_TS_STUB(TSMutexUnlock)
+TXN_BOX_TS_STUB(TSPluginDSOReloadEnable)
+TXN_BOX_TS_STUB(TSPluginRegister)
+TXN_BOX_TS_STUB(TSProcessUuidGet)
+TXN_BOX_TS_STUB(TSStatCreate)
+TXN_BOX_TS_STUB(TSStatIntGet)
+TXN_BOX_TS_STUB(TSStatIntIncrement)
+TXN_BOX_TS_STUB(TSStatIntSet)
+TXN_BOX_TS_STUB(TSStringPercentDecode)
+TXN_BOX_TS_STUB(TSStringPercentEncode)
+TXN_BOX_TS_STUB(TSThreadSelf)
+TXN_BOX_TS_STUB(TSTransformCreate)
+TXN_BOX_TS_STUB(TSTransformOutputVConnGet)
+TXN_BOX_TS_STUB(TSUrlCreate)
+TXN_BOX_TS_STUB(TSUrlHostGet)
+TXN_BOX_TS_STUB(TSUrlHostSet)
+TXN_BOX_TS_STUB(TSUrlHttpFragmentGet)
+TXN_BOX_TS_STUB(TSUrlHttpFragmentSet)
+TXN_BOX_TS_STUB(TSUrlHttpQueryGet)
+TXN_BOX_TS_STUB(TSUrlHttpQuerySet)
+TXN_BOX_TS_STUB(TSUrlParse)
+TXN_BOX_TS_STUB(TSUrlPathGet)
+TXN_BOX_TS_STUB(TSUrlPathSet)
+TXN_BOX_TS_STUB(TSUrlPortGet)
+TXN_BOX_TS_STUB(TSUrlPortSet)
+TXN_BOX_TS_STUB(TSUrlPrint)
+TXN_BOX_TS_STUB(TSUrlSchemeGet)
+TXN_BOX_TS_STUB(TSUrlSchemeSet)
+TXN_BOX_TS_STUB(TSUserArgGet)
+TXN_BOX_TS_STUB(TSUserArgIndexNameLookup)
+TXN_BOX_TS_STUB(TSUserArgIndexReserve)
+TXN_BOX_TS_STUB(TSUserArgSet)
+TXN_BOX_TS_STUB(TSUuidStringGet)
+TXN_BOX_TS_STUB(TSVConnClosedGet)
+TXN_BOX_TS_STUB(TSVConnSSLConnectionGet)
+TXN_BOX_TS_STUB(TSVConnShutdown)
+TXN_BOX_TS_STUB(TSVConnSslConnectionGet)
+TXN_BOX_TS_STUB(TSVConnWrite)
+TXN_BOX_TS_STUB(TSVConnWriteVIOGet)
+TXN_BOX_TS_STUB(TSVIOBufferGet)
+TXN_BOX_TS_STUB(TSVIOContGet)
+TXN_BOX_TS_STUB(TSVIONBytesGet)
+TXN_BOX_TS_STUB(TSVIONBytesSet)
+TXN_BOX_TS_STUB(TSVIONDoneGet)
+TXN_BOX_TS_STUB(TSVIONDoneSet)
+TXN_BOX_TS_STUB(TSVIONTodoGet)
+TXN_BOX_TS_STUB(TSVIOReaderGet)
+TXN_BOX_TS_STUB(TSVIOReenable)
+
+#undef TXN_BOX_TS_STUB
+
+} // extern "C"
@@ -0,0 +1,107 @@
+/** @file
+   Offline configuration checker.
+
+   Load configuration files the same way the plugin does, but without a running Traffic Server.
+   Errors are reported and, on success, the load time and resource use of the configuration.
+
+   Usage: txn_box_check [--remap] [--debug] [--ip-space-out <dir>] <plugin arguments>
+
+   The plugin arguments are the same as for the global plugin in "plugin.config" or the remap plugin
+   in "remap.config", e.g. "--key meta.txn_box global.yaml". Relative paths are resolved against the
+   current directory. If "--ip-space-out" is used, the IP spaces defined in the configuration are
+   written to @a dir in the binary format.
+
+ * Copyright 2021, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <swoc/TextView.h>
+#include <swoc/bwf_std.h>
+
+#include "txn_box/common.h"
+#include "txn_box/Config.h"
+#include "txn_box/Accelerator.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using namespace swoc::literals;
+
+extern bool Stub_Debug_P; // ts_stub.cc
+extern Errata IP_Space_Write_Binary(Config &cfg, swoc::file::path const &dir); // ip_space.cc
+
+int
+main(int argc, char const *argv[])
+{
+  static constexpr TextView REMAP_OPT = "--remap";
+  static constexpr TextView DEBUG_OPT = "--debug";
+  static constexpr TextView SPACE_OPT = "--ip-space-out";
+
+  bool remap_p = false;
+  swoc::file::path space_dir;
+  int arg_idx = 1;
+  for (; arg_idx < argc; ++arg_idx) {
+    TextView arg{argv[arg_idx], strlen(argv[arg_idx])};
+    if (arg == REMAP_OPT) {
+      remap_p = true;
+    } else if (arg == DEBUG_OPT) {
+      Stub_Debug_P = true;
+    } else if (arg == SPACE_OPT && arg_idx + 1 < argc) {
+      space_dir = argv[++arg_idx];
+    } else {
+      break;
+    }
+  }
+
+  if (arg_idx >= argc) {
+    std::cerr << "Usage: " << argv[0] << " [" << REMAP_OPT << "] [" << DEBUG_OPT << "] [" << SPACE_OPT << " <dir>] <plugin arguments>"
+              << std::endl;
+    return 2;
+  }
+
+  std::string text;
+  if (!G._preload_errata.is_ok()) {
+    std::cerr << swoc::bwprint(text, "{}: startup issues.\n{}", Config::PLUGIN_NAME, G._preload_errata) << std::endl;
+    return 1;
+  }
+
+  auto cfg = std::make_shared<Config>();
+  if (remap_p) {
+    cfg->mark_as_remap();
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  auto errata = cfg->load_cli_args(cfg, swoc::MemSpan<char const *>{argv + arg_idx, size_t(argc - arg_idx)}, 0);
+  auto delta = std::chrono::steady_clock::now() - t0;
+
+  if (!errata.is_ok()) {
+    std::cerr << swoc::bwprint(text, "{}: configuration failed to load.\n{}", Config::PLUGIN_NAME, errata) << std::endl;
+    return 1;
+  }
+  if (!errata.empty()) { // warnings.
+    std::cerr << swoc::bwprint(text, "{}", errata) << std::endl;
+  }
+
+  std::cout << swoc::bwprint(text, "{} files loaded in {} ms.", cfg->file_count(),
+                             std::chrono::duration_cast<std::chrono::milliseconds>(delta).count())
+            << std::endl;
+  std::cout << swoc::bwprint(text, "{}", *cfg) << std::endl;
+  auto const &accl = cfg->accelerator_counters();
+  std::cout << swoc::bwprint(text, "{} comparisons, {} can be string accelerated.", cfg->comparison_count(),
+                             accl[Accelerator::BY_STRING])
+            << std::endl;
+
+  if (!space_dir.empty()) {
+    errata = IP_Space_Write_Binary(*cfg, space_dir);
+    if (!errata.is_ok()) {
+      std::cerr << swoc::bwprint(text, "{}: failed to write IP spaces.\n{}", Config::PLUGIN_NAME, errata) << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}